@@ -20,17 +20,21 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 
 #include "final/fapplication.h"
 #include "final/fevent.h"
+#include "final/feventqueue.h"
 #include "final/fmenu.h"
 #include "final/fmenubar.h"
 #include "final/fmessagebox.h"
 #include "final/fmouse.h"
 #include "final/fstartoptions.h"
 #include "final/fstatusbar.h"
+#include "final/ftaskregistry.h"
 #include "final/ftermios.h"
 #include "final/fwidgetcolors.h"
 #include "final/fwindow.h"
@@ -57,6 +61,8 @@ FMouseControl* FApplication::mouse           {nullptr};  // mouse control
 int            FApplication::loop_level      {0};  // event loop level
 int            FApplication::quit_code       {0};
 bool           FApplication::quit_now        {false};
+FEventQueue*   FApplication::posted_events   {nullptr};  // cross-thread events
+FWorkerPool*   FApplication::worker_pool     {nullptr};  // background tasks
 
 FApplication::eventQueue* FApplication::event_queue{nullptr};
 
@@ -96,6 +102,22 @@ FApplication::~FApplication()  // destructor
   if ( event_queue )
     delete event_queue;
 
+  if ( worker_pool )
+  {
+    // Waits for the running tasks before the event queue is gone
+    delete worker_pool;
+    worker_pool = nullptr;
+  }
+
+  FTaskRegistry::clear();
+
+  if ( posted_events )
+  {
+    watcher.delWatch (posted_events->getWakeupDescriptor());
+    delete posted_events;
+    posted_events = nullptr;
+  }
+
   app_object = nullptr;
 }
 
@@ -239,6 +261,49 @@ void FApplication::queueEvent ( const FObject* receiver
   event_queue->push_back(send_event);
 }
 
+//----------------------------------------------------------------------
+void FApplication::postEvent ( const FObject* receiver
+                             , int user_id
+                             , FDataPtr data )
+{
+  // Queues a user event (fc::User_Event) for the receiver and wakes
+  // up the event loop. Unlike queueEvent(), this function can be
+  // called from any thread. The data pointer is passed unchanged
+  // to the FUserEvent and must stay valid until it is received.
+  // Events for a receiver that is destroyed before are dropped.
+
+  if ( posted_events )
+    posted_events->post (receiver, user_id, data);
+}
+
+//----------------------------------------------------------------------
+bool FApplication::runInBackground ( const FObject* receiver
+                                   , const FTask& task
+                                   , const FTask& done )
+{
+  // Runs the task in a worker thread. The function done is then
+  // called in the event loop for the receiver (the application
+  // object for nullptr). It is not called when the receiver is
+  // destroyed before. The task must not access any widgets,
+  // results can be passed to done via a shared captured object.
+
+  if ( ! worker_pool || ! task )
+    return false;
+
+  if ( ! done )
+    return worker_pool->submit(task);
+
+  if ( ! receiver )
+    receiver = app_object;
+
+  return FTaskRegistry::submit ( *worker_pool, receiver, task, done
+                               , [] (const FObject* r, const FTask& fn)
+                                 {
+                                   if ( posted_events )
+                                     posted_events->post (r, fn);
+                                 } );
+}
+
 //----------------------------------------------------------------------
 void FApplication::sendQueuedEvents()
 {
@@ -262,13 +327,17 @@ bool FApplication::eventInQueue()
 //----------------------------------------------------------------------
 bool FApplication::removeQueuedEvent (const FObject* receiver)
 {
-  if ( ! eventInQueue() )
-    return false;
-
   if ( ! receiver )
     return false;
 
   bool retval{false};
+  cancelTasks (receiver);
+
+  if ( posted_events )
+    retval = posted_events->remove(receiver);
+
+  if ( ! eventInQueue() )
+    return retval;
   auto iter = event_queue->begin();
 
   while ( iter != event_queue->end() )
@@ -357,6 +426,23 @@ void FApplication::closeConfirmationDialog (FWidget* w, FCloseEvent* ev)
     ev->ignore();
 }
 
+//----------------------------------------------------------------------
+bool FApplication::addWatch ( int fd, int events
+                            , const FWatcher::FWatchCallback& callback )
+{
+  // Calls the callback function from the event loop as soon as
+  // the file descriptor is ready for the given events
+  // (FWatcher::read_event, FWatcher::write_event)
+
+  return watcher.addWatch (fd, events, callback);
+}
+
+//----------------------------------------------------------------------
+bool FApplication::delWatch (int fd)
+{
+  return watcher.delWatch (fd);
+}
+
 // private methods of FApplication
 //----------------------------------------------------------------------
 void FApplication::init (uInt64 key_time, uInt64 dblclick_time)
@@ -377,6 +463,7 @@ void FApplication::init (uInt64 key_time, uInt64 dblclick_time)
     keyboard->setReleaseCommand (key_cmd2);
     keyboard->setEscPressedCommand (key_cmd3);
     keyboard->setKeypressTimeout (key_time);
+    keyboard->setWatcher (&watcher);
   }
 
   // Initialize mouse control
@@ -393,12 +480,29 @@ void FApplication::init (uInt64 key_time, uInt64 dblclick_time)
   try
   {
     event_queue = new eventQueue;
+    posted_events = new FEventQueue;
+    worker_pool = new FWorkerPool;  // Threads start with the first task
   }
   catch (const std::bad_alloc& ex)
   {
     std::cerr << bad_alloc_str << ex.what() << std::endl;
     std::abort();
   }
+
+  // Posted events from other threads wake up the event loop
+  watcher.addWatch ( posted_events->getWakeupDescriptor()
+                   , FWatcher::read_event
+                   , [this] (int, int)
+                     {
+                       processPostedEvents();
+                     } );
+}
+
+//----------------------------------------------------------------------
+void FApplication::cancelTasks (const FObject* receiver)
+{
+  // Drops the continuations of the receiver's background tasks
+  FTaskRegistry::cancel (receiver);
 }
 
 //----------------------------------------------------------------------
@@ -526,7 +630,13 @@ inline void FApplication::findKeyboardWidget()
 inline bool FApplication::isKeyPressed()
 {
   if ( mouse && mouse->isGpmMouseEnabled() )
-    return mouse->getGpmKeyPressed(keyboard->unprocessedInput());
+  {
+    // The gpm mouse waits in its own select() call,
+    // so the watched file descriptors are only checked afterwards
+    bool key_pressed = mouse->getGpmKeyPressed(keyboard->unprocessedInput());
+    watcher.poll(0);
+    return key_pressed;
+  }
 
   return keyboard->isKeyPressed();
 }
@@ -559,33 +669,20 @@ inline void FApplication::performKeyboardAction()
       break;
 
     case fc::Fkey_mouse:
-      if ( mouse )
-      {
-        FKeyboard::keybuffer& buffer = keyboard->getKeyBuffer();
-        mouse->setRawData (FMouse::x11, buffer);
-        keyboard->unprocessedInput() = mouse->isInputDataPending();
-        processMouseEvent();
-      }
+      processMouseReports (FMouse::x11);
       break;
 
     case fc::Fkey_extended_mouse:
-      if ( mouse )
-      {
-        FKeyboard::keybuffer& buffer = keyboard->getKeyBuffer();
-        mouse->setRawData (FMouse::sgr, buffer);
-        keyboard->unprocessedInput() = mouse->isInputDataPending();
-        processMouseEvent();
-      }
+      processMouseReports (FMouse::sgr);
       break;
 
     case fc::Fkey_urxvt_mouse:
-      if ( mouse )
-      {
-        FKeyboard::keybuffer& buffer = keyboard->getKeyBuffer();
-        mouse->setRawData (FMouse::urxvt, buffer);
-        keyboard->unprocessedInput() = mouse->isInputDataPending();
-        processMouseEvent();
-      }
+      processMouseReports (FMouse::urxvt);
+      break;
+
+    case fc::Fkey_paste:
+      if ( ! sendPasteEvent (keyboard_widget) )
+        sendPastedKeys (keyboard_widget);
       break;
 
     default:
@@ -634,6 +731,39 @@ inline bool FApplication::sendKeyUpEvent (FWidget* widget)
   return k_up_ev.isAccepted();
 }
 
+//----------------------------------------------------------------------
+inline bool FApplication::sendPasteEvent (FWidget* widget)
+{
+  // Send the pasted text as a whole
+  FPasteEvent paste_ev (fc::Paste_Event, keyboard->getPasteText());
+  sendEvent (widget, &paste_ev);
+  return paste_ev.isAccepted();
+}
+
+//----------------------------------------------------------------------
+void FApplication::sendPastedKeys (FWidget* widget)
+{
+  // Widgets without paste support get the pasted text as
+  // single keystrokes (without keyboard accelerators).
+  // C0 and C1 control codes other than line feed and tab are
+  // dropped, so that a pasted escape cannot close a dialog.
+
+  for (auto&& ch : keyboard->getPasteText())
+  {
+    if ( FKeyboard::isControlCharacter(ch)
+      && ch != L'\n' && ch != L'\t' )
+      continue;
+
+    const FKey key = ( ch == L'\n' ) ? FKey(fc::Fkey_return) : FKey(ch);
+    FKeyEvent k_down_ev (fc::KeyDown_Event, key);
+    sendEvent (widget, &k_down_ev);
+    FKeyEvent k_press_ev (fc::KeyPress_Event, key);
+    sendEvent (widget, &k_press_ev);
+    FKeyEvent k_up_ev (fc::KeyUp_Event, key);
+    sendEvent (widget, &k_up_ev);
+  }
+}
+
 //----------------------------------------------------------------------
 inline void FApplication::sendKeyboardAccelerator()
 {
@@ -672,6 +802,9 @@ void FApplication::processKeyboardEvent()
   flushOutputBuffer();
   keyboard->clearKeyBufferOnTimeout();
 
+  // Waits for input no longer than until the next event deadline
+  keyboard->setReadBlockingTime (getWaitingTime());
+
   if ( isKeyPressed() )
     keyboard->fetchKeyCode();
 
@@ -679,6 +812,25 @@ void FApplication::processKeyboardEvent()
   keyboard->escapeKeyHandling();
 }
 
+//----------------------------------------------------------------------
+uInt64 FApplication::getWaitingTime()
+{
+  // Returns the time (in µs) until the next timer, frame or
+  // keypress timeout is due. Without any deadline, the event loop
+  // sleeps until input or a window resize signal wakes it up.
+
+  if ( eventInQueue()
+    || ( getWidgetCloseList() && ! getWidgetCloseList()->empty() ) )
+    return 0;
+
+  uInt64 waiting_time = getNextTimerDelay(std::numeric_limits<uInt64>::max());
+
+  if ( isTerminalUpdatePending() )
+    waiting_time = std::min(waiting_time, getNextFrameDelay());
+
+  return keyboard->getKeypressTimeoutDelay(waiting_time);
+}
+
 //----------------------------------------------------------------------
 bool FApplication::processDialogSwitchAccelerator()
 {
@@ -1132,6 +1284,28 @@ void FApplication::processMouseEvent()
     mouse->drawGpmPointer();
 }
 
+//----------------------------------------------------------------------
+void FApplication::processMouseReports (int mouse_type)
+{
+  // The key buffer can hold several reports of the mouse protocol
+
+  if ( ! mouse )
+    return;
+
+  FKeyboard::keybuffer& buffer = keyboard->getKeyBuffer();
+  const auto protocol = FMouse::mouse_type(mouse_type);
+
+  // Only the reports of this protocol are in the key buffer
+  // (pending gpm data must not repeat the loop)
+  do
+  {
+    mouse->setRawData (protocol, buffer);
+    keyboard->unprocessedInput() = mouse->isInputDataPending(protocol);
+    processMouseEvent();
+  }
+  while ( mouse && mouse->isInputDataPending(protocol) );
+}
+
 //----------------------------------------------------------------------
 void FApplication::processResizeEvent()
 {
@@ -1166,6 +1340,49 @@ void FApplication::processCloseWidget()
   updateTerminal (FVTerm::start_refresh);
 }
 
+//----------------------------------------------------------------------
+uInt FApplication::processWatchEvents()
+{
+  // Calls the callbacks of ready file descriptors
+
+  if ( ! watcher.hasReadyEvents() )
+    return 0;
+
+  return uInt(watcher.dispatch());
+}
+
+//----------------------------------------------------------------------
+uInt FApplication::processPostedEvents()
+{
+  // Sends the events posted by other threads. Events that are
+  // posted in the meantime are sent on the next wakeup.
+
+  if ( ! posted_events )
+    return 0;
+
+  uInt num_events{0};
+  std::size_t n = posted_events->collect();
+  FEventQueue::FPostedEvent posted{};
+
+  while ( n > 0 && posted_events->fetch(posted) )
+  {
+    num_events++;
+    n--;
+
+    if ( posted.callback )
+    {
+      posted.callback();  // Continuation of a background task
+      continue;
+    }
+
+    FUserEvent user_ev (fc::User_Event, posted.user_id);
+    user_ev.setData (posted.data);
+    sendEvent (posted.receiver, &user_ev);
+  }
+
+  return num_events;
+}
+
 //----------------------------------------------------------------------
 bool FApplication::processNextEvent()
 {
@@ -1174,12 +1391,15 @@ bool FApplication::processNextEvent()
   processKeyboardEvent();
   processMouseEvent();
   processResizeEvent();
-  processTerminalUpdate();
   processCloseWidget();
+  num_events += processWatchEvents();
 
   sendQueuedEvents();
   num_events += processTimerEvent();
 
+  // Draws all changes of this loop pass in a single frame
+  processTerminalUpdate();
+
   return ( num_events > 0 );
 }
 
@@ -694,7 +694,8 @@ void FButton::updateButtonColor()
 //----------------------------------------------------------------------
 void FButton::processClick()
 {
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 }  // namespace finalcut
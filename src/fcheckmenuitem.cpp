@@ -70,7 +70,8 @@ void FCheckMenuItem::init (FWidget* parent)
 //----------------------------------------------------------------------
 void FCheckMenuItem::processToggle()
 {
-  emitCallback("toggled");
+  static const FSignalId toggled = getSignalId("toggled");
+  emitCallback(toggled);
 }
 
 //----------------------------------------------------------------------
@@ -82,7 +83,8 @@ void FCheckMenuItem::processClicked()
     setChecked();
 
   processToggle();
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 }  // namespace finalcut
@@ -70,6 +70,36 @@ void FKeyEvent::ignore()
 { accpt = false; }
 
 
+//----------------------------------------------------------------------
+// class FPasteEvent
+//----------------------------------------------------------------------
+
+FPasteEvent::FPasteEvent (fc::events ev_type, const FString& txt)  // constructor
+  : FEvent(ev_type)
+  , text{txt}
+{ }
+
+//----------------------------------------------------------------------
+FPasteEvent::~FPasteEvent()  // destructor
+{ }
+
+//----------------------------------------------------------------------
+const FString& FPasteEvent::getText() const
+{ return text; }
+
+//----------------------------------------------------------------------
+bool FPasteEvent::isAccepted() const
+{ return accpt; }
+
+//----------------------------------------------------------------------
+void FPasteEvent::accept()
+{ accpt = true; }
+
+//----------------------------------------------------------------------
+void FPasteEvent::ignore()
+{ accpt = false; }
+
+
 //----------------------------------------------------------------------
 // class FMouseEvent
 //----------------------------------------------------------------------
@@ -0,0 +1,242 @@
+/***********************************************************************
+* feventqueue.cpp - Thread-safe queue for posted user events           *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+  #include <sys/eventfd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "final/feventqueue.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FEventQueue
+//----------------------------------------------------------------------
+
+// constructors and destructor
+//----------------------------------------------------------------------
+FEventQueue::FEventQueue()
+{
+  createWakeupDescriptor();
+}
+
+//----------------------------------------------------------------------
+FEventQueue::~FEventQueue()  // destructor
+{
+  FNode* node = head.exchange(nullptr);
+
+  while ( node )
+  {
+    FNode* next = node->next;
+    delete node;
+    node = next;
+  }
+
+  if ( wakeup_fd[1] != -1 && wakeup_fd[1] != wakeup_fd[0] )
+    ::close (wakeup_fd[1]);
+
+  if ( wakeup_fd[0] != -1 )
+    ::close (wakeup_fd[0]);
+}
+
+
+// public methods of FEventQueue
+//----------------------------------------------------------------------
+bool FEventQueue::isEmpty() const
+{
+  return pending.empty() && ! head.load();
+}
+
+//----------------------------------------------------------------------
+void FEventQueue::post ( const FObject* receiver
+                       , int user_id
+                       , FDataPtr data )
+{
+  // Adds an event for the receiver (can be called from any thread)
+
+  if ( ! receiver )
+    return;
+
+  push ({receiver, user_id, data, nullptr});
+}
+
+//----------------------------------------------------------------------
+void FEventQueue::post ( const FObject* receiver
+                       , const FCallback& callback )
+{
+  // Adds a function call that the consumer thread makes on behalf
+  // of the receiver (can be called from any thread)
+
+  if ( ! receiver || ! callback )
+    return;
+
+  push ({receiver, 0, nullptr, callback});
+}
+
+//----------------------------------------------------------------------
+std::size_t FEventQueue::collect()
+{
+  // Moves the events of the producers into the consumer queue
+  // and returns the number of events to fetch (consumer thread only).
+  // The descriptor is drained before the wakeup flag is reset, so
+  // that the wakeup of an event posted in between is not lost.
+
+  clearWakeup();
+  wakeup_pending.store(false);
+  FNode* node = head.exchange(nullptr);
+  FNode* reversed{nullptr};
+
+  // The stack holds the newest event first
+  while ( node )
+  {
+    FNode* next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+
+  while ( reversed )
+  {
+    FNode* next = reversed->next;
+    pending.push_back(reversed->event);
+    delete reversed;
+    reversed = next;
+  }
+
+  return pending.size();
+}
+
+//----------------------------------------------------------------------
+bool FEventQueue::fetch (FPostedEvent& event)
+{
+  // Takes the oldest collected event (consumer thread only)
+
+  if ( pending.empty() )
+    return false;
+
+  event = pending.front();
+  pending.pop_front();
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool FEventQueue::remove (const FObject* receiver)
+{
+  // Removes all events of the receiver (consumer thread only)
+
+  collect();
+  auto size = pending.size();
+  pending.erase ( std::remove_if ( pending.begin(), pending.end()
+                                 , [receiver] (const FPostedEvent& ev)
+                                   {
+                                     return ev.receiver == receiver;
+                                   } )
+                , pending.end() );
+
+  // The remaining collected events need a new wakeup
+  if ( ! pending.empty() && ! wakeup_pending.exchange(true) )
+    wakeUp();
+
+  return pending.size() != size;
+}
+
+
+// private methods of FEventQueue
+//----------------------------------------------------------------------
+void FEventQueue::push (const FPostedEvent& event)
+{
+  FNode* node = new (std::nothrow) FNode{event, nullptr};
+
+  if ( ! node )
+    return;
+
+  node->next = head.load();
+
+  while ( ! head.compare_exchange_weak(node->next, node) )
+    continue;
+
+  // Only the first event after the last collect() wakes up the consumer
+  if ( ! wakeup_pending.exchange(true) )
+    wakeUp();
+}
+
+//----------------------------------------------------------------------
+void FEventQueue::createWakeupDescriptor()
+{
+#if defined(__linux__)
+  wakeup_fd[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if ( wakeup_fd[0] != -1 )
+  {
+    wakeup_fd[1] = wakeup_fd[0];
+    return;
+  }
+#endif
+
+  // Self-pipe as a fallback
+  if ( pipe(wakeup_fd) == -1 )
+  {
+    wakeup_fd[0] = wakeup_fd[1] = -1;
+    return;
+  }
+
+  for (int fd : wakeup_fd)
+  {
+    fcntl (fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl (fd, F_SETFD, FD_CLOEXEC);
+  }
+}
+
+//----------------------------------------------------------------------
+void FEventQueue::wakeUp()
+{
+  if ( wakeup_fd[1] == -1 )
+    return;
+
+  // An eventfd needs an 8-byte counter value, a pipe one byte
+  const uInt64 value{1};
+  const bool is_eventfd = ( wakeup_fd[0] == wakeup_fd[1] );
+  ssize_t ret = ::write (wakeup_fd[1], &value, is_eventfd ? sizeof(value) : 1);
+  (void)ret;
+}
+
+//----------------------------------------------------------------------
+void FEventQueue::clearWakeup()
+{
+  if ( wakeup_fd[0] == -1 )
+    return;
+
+  uInt64 buf[8];
+
+  while ( ::read(wakeup_fd[0], buf, sizeof(buf)) > 0 )
+    continue;
+}
+
+}  // namespace finalcut
@@ -0,0 +1,128 @@
+/***********************************************************************
+* fframescheduler.cpp - Schedules the frames of the terminal output    *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <algorithm>
+
+#include "final/fframescheduler.h"
+#include "final/fobject.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FFrameScheduler
+//----------------------------------------------------------------------
+
+// public methods of FFrameScheduler
+//----------------------------------------------------------------------
+uInt64 FFrameScheduler::getFrameInterval() const
+{
+  // Returns the minimum time (in µs) between two frames
+
+  const uInt64 interval = ( max_frame_rate > 0 )
+                          ? 1000000 / max_frame_rate
+                          : 0;
+  return std::max(interval, min_frame_interval);
+}
+
+//----------------------------------------------------------------------
+uInt64 FFrameScheduler::getFrameTimeBudget() const
+{
+  // Returns the time (in µs) that may be spent for drawing one frame
+
+  if ( frame_time_budget > 0 )
+    return frame_time_budget;
+
+  if ( max_frame_rate > 0 )
+    return uInt64(1000000 / max_frame_rate);
+
+  return 0;  // No budget
+}
+
+//----------------------------------------------------------------------
+uInt64 FFrameScheduler::getNextFrameDelay (const timeval& now) const
+{
+  // Returns the remaining time (in µs) until the next frame is due
+
+  const uInt64 interval = getFrameInterval();
+
+  if ( interval == 0 || frame_count == 0 )
+    return 0;
+
+  const timeval diff = now - last_frame_time;
+  const uInt64 elapsed = uInt64(diff.tv_sec) * 1000000
+                       + uInt64(diff.tv_usec);
+
+  if ( diff.tv_sec < 0 || elapsed >= interval )
+    return 0;
+
+  return interval - elapsed;
+}
+
+//----------------------------------------------------------------------
+bool FFrameScheduler::isFrameDue (const timeval& now) const
+{
+  // Checks whether the minimum interval between two frames has elapsed
+
+  return getNextFrameDelay(now) == 0;
+}
+
+//----------------------------------------------------------------------
+bool FFrameScheduler::requestUpdate (const timeval& now)
+{
+  // Returns true if a change may be drawn immediately.
+  // Otherwise, the change is coalesced into the next scheduled frame.
+
+  if ( ! render_on_idle && isFrameDue(now) )
+    return true;
+
+  deferUpdate();
+  return false;
+}
+
+//----------------------------------------------------------------------
+void FFrameScheduler::countFrame ( const timeval& frame_start
+                                 , const timeval& frame_end )
+{
+  // Frames that exceed the frame-time budget
+  // cause the following frame slots to be dropped
+
+  const timeval diff = frame_end - frame_start;
+  const uInt64 frame_time = uInt64(diff.tv_sec) * 1000000
+                          + uInt64(diff.tv_usec);
+  const uInt64 budget = getFrameTimeBudget();
+  last_frame_time = frame_start;
+  frame_count++;
+
+  if ( diff.tv_sec >= 0 && budget > 0 && frame_time > budget )
+    dropped_frames += frame_time / budget;
+}
+
+//----------------------------------------------------------------------
+void FFrameScheduler::resetCounters()
+{
+  frame_count = 0;
+  coalesced_frames = 0;
+  dropped_frames = 0;
+}
+
+}  // namespace finalcut
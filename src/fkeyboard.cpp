@@ -21,11 +21,11 @@
 ***********************************************************************/
 
 #include <fcntl.h>
+#include <poll.h>
 
-#if defined(__CYGWIN__)
-  #include <sys/select.h>  // need for FD_ZERO, FD_SET, FD_CLR, ...
-#endif
-
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <string>
 
 #include "final/fkeyboard.h"
@@ -41,7 +41,19 @@
 namespace finalcut
 {
 
+namespace
+{
+
+// Bracketed paste markers (xterm private mode 2004)
+const char PASTE_BEGIN[] = CSI "200~";
+const char PASTE_END[] = CSI "201~";
+constexpr std::size_t PASTE_MARKER_LEN{6};
+constexpr uInt64 PASTE_TIMEOUT{1000000};  // 1 s without data
+
+}  // anonymous namespace
+
 // static class attributes
+constexpr std::size_t FKeyFifo::MAX_SIZE;
 uInt64 FKeyboard::key_timeout{100000};  // 100 ms (default timeout for keypress)
 struct timeval FKeyboard::time_keypressed{};
 
@@ -50,6 +62,225 @@ struct timeval FKeyboard::time_keypressed{};
 #endif
 
 
+//----------------------------------------------------------------------
+// class FKeyTrie
+//----------------------------------------------------------------------
+
+// public methods of FKeyTrie
+//----------------------------------------------------------------------
+bool FKeyTrie::insert (const char sequence[], FKey num)
+{
+  // Adds a key sequence. If the sequence already exists,
+  // the first inserted key is kept.
+
+  if ( ! sequence || sequence[0] == '\0' )
+    return false;
+
+  if ( nodes.empty() )
+    nodes.push_back({0, 0, 0, 0, 0, '\0', false});  // Root node
+
+  uInt index{0};
+
+  for (const char* p = sequence; *p != '\0'; p++)
+  {
+    uInt child = findChild(index, *p);
+
+    if ( child == 0 )
+    {
+      addChild (index, *p);
+      child = uInt(nodes.size() - 1);
+    }
+
+    index = child;
+  }
+
+  if ( nodes[index].is_key )
+    return false;
+
+  nodes[index].num = num;
+  nodes[index].is_key = true;
+  return true;
+}
+
+//----------------------------------------------------------------------
+FKeyTrie::FMatch FKeyTrie::match (const char buffer[], std::size_t len) const
+{
+  // Decodes the key at the beginning of the buffer in a single pass
+
+  FMatch result{no_match, 0, 0};
+
+  if ( ! buffer || len == 0 || isEmpty() )
+    return result;
+
+  uInt index{0};
+  uInt last_key{0};  // Last key node passed on the way (0 = none)
+  std::size_t last_key_length{0};
+
+  for (std::size_t i{0}; i < len; i++)
+  {
+    const uInt child = findChild(index, buffer[i]);
+
+    if ( child != 0 )
+    {
+      index = child;
+
+      if ( nodes[index].is_key )
+      {
+        last_key = index;
+        last_key_length = i + 1;
+      }
+
+      continue;
+    }
+
+    if ( nodes[index].is_key && nodes[index].first_child == 0 )
+      return {complete_match, nodes[index].num, i};
+
+    // A passed key that begins longer keys (e.g. Meta-O, Meta-[)
+    // is followed by other input. The key is used after the timeout
+    // and the rest of the input is kept.
+    if ( last_key != 0 )
+      result = {prefix_match, nodes[last_key].num, last_key_length};
+
+    return result;
+  }
+
+  const FNode& node = nodes[index];
+
+  if ( node.first_child == 0 )
+    return {complete_match, node.num, len};
+
+  result.type = prefix_match;
+
+  if ( node.is_key )
+  {
+    result.num = node.num;
+    result.length = len;
+  }
+
+  return result;
+}
+
+//----------------------------------------------------------------------
+void FKeyTrie::clear()
+{
+  nodes.clear();
+  jump_tables.clear();
+}
+
+
+// private methods of FKeyTrie
+//----------------------------------------------------------------------
+inline uInt FKeyTrie::findChild (uInt index, char byte) const
+{
+  const FNode& node = nodes[index];
+
+  if ( node.jump_table != 0 )
+    return jump_tables[(node.jump_table - 1) * 256 + uChar(byte)];
+
+  uInt child = node.first_child;
+
+  while ( child != 0 && nodes[child].byte != byte )
+    child = nodes[child].next_sibling;
+
+  return child;
+}
+
+//----------------------------------------------------------------------
+void FKeyTrie::addChild (uInt index, char byte)
+{
+  const uInt child = uInt(nodes.size());
+  nodes.push_back({0, 0, nodes[index].first_child, 0, 0, byte, false});
+  FNode& node = nodes[index];
+  node.first_child = child;
+  node.children++;
+
+  if ( node.jump_table != 0 )
+    jump_tables[(node.jump_table - 1) * 256 + uChar(byte)] = child;
+  else if ( node.children == JUMP_TABLE_MIN )
+    createJumpTable (index);
+}
+
+//----------------------------------------------------------------------
+void FKeyTrie::createJumpTable (uInt index)
+{
+  // Nodes with many children (e.g. after ESC) get a table
+  // that finds the next node without a sibling search
+
+  const std::size_t offset = jump_tables.size();
+  jump_tables.resize (offset + 256, 0);
+  uInt child = nodes[index].first_child;
+
+  while ( child != 0 )
+  {
+    jump_tables[offset + uChar(nodes[child].byte)] = child;
+    child = nodes[child].next_sibling;
+  }
+
+  nodes[index].jump_table = uInt(offset / 256 + 1);
+}
+
+
+//----------------------------------------------------------------------
+// class FKeyFifo
+//----------------------------------------------------------------------
+
+// public methods of FKeyFifo
+//----------------------------------------------------------------------
+std::size_t FKeyFifo::append (const char data[], std::size_t len)
+{
+  // Adds the data at the end and returns the number of added bytes.
+  // The stored bytes are moved to the front only if the free space
+  // at the end is too small, the buffer grows up to MAX_SIZE.
+
+  if ( ! data || len == 0 )
+    return 0;
+
+  if ( head + length + len > buffer.size() && head > 0 )
+  {
+    std::memmove (buffer.data(), buffer.data() + head, length);
+    head = 0;
+  }
+
+  if ( length + len > buffer.size() )
+  {
+    std::size_t size = std::max(buffer.size() * 2, std::size_t(1024));
+
+    while ( size < length + len )
+      size *= 2;
+
+    buffer.resize (std::min(size, MAX_SIZE));
+  }
+
+  len = std::min(len, buffer.size() - length);
+  std::memcpy (buffer.data() + head + length, data, len);
+  length += len;
+  return len;
+}
+
+//----------------------------------------------------------------------
+void FKeyFifo::consume (std::size_t len)
+{
+  // Removes len bytes from the front by advancing the head index
+
+  if ( len >= length )
+  {
+    clear();
+    return;
+  }
+
+  head += len;
+  length -= len;
+}
+
+//----------------------------------------------------------------------
+void FKeyFifo::clear()
+{
+  head = 0;
+  length = 0;
+}
+
+
 //----------------------------------------------------------------------
 // class FKeyboard
 //----------------------------------------------------------------------
@@ -67,6 +298,8 @@ FKeyboard::FKeyboard()
 
   if ( stdin_status_flags == -1 )
     std::abort();
+
+  buildKeyTrie();
 }
 
 //----------------------------------------------------------------------
@@ -97,6 +330,7 @@ const FString FKeyboard::getKeyName (FKey keynum)
 void FKeyboard::setTermcapMap (fc::FKeyMap* keymap)
 {
   key_map = keymap;
+  buildKeyTrie();
 }
 
 //----------------------------------------------------------------------
@@ -116,20 +350,63 @@ bool& FKeyboard::unprocessedInput()
 //----------------------------------------------------------------------
 bool FKeyboard::isKeyPressed()
 {
-  fd_set ifds{};
-  struct timeval tv{};
-  int stdin_no = FTermios::getStdIn();
+  // Waits until input arrives, the read blocking time has elapsed,
+  // a window resize signal wakes up the event loop or a watched
+  // file descriptor becomes ready
+
+  struct pollfd stdin_fd{};
+  struct pollfd signal_fd{};
+  int timeout{-1};  // Waits without time limit
+  stdin_fd.fd = FTermios::getStdIn();
+  stdin_fd.events = POLLIN;
+  signal_fd.fd = FTerm::getSignalPipe();  // Ignored by poll() if -1
+  signal_fd.events = POLLIN;
+  poll_list.clear();
+  poll_list.push_back(stdin_fd);
+  poll_list.push_back(signal_fd);
+
+  if ( watcher )
+    watcher->appendPollList (poll_list);
+
+  if ( read_blocking_time < uInt64(INT_MAX) * 1000 )
+    timeout = int((read_blocking_time + 999) / 1000);  // Rounds up to ms
+
+  int result = poll (poll_list.data(), poll_list.size(), timeout);
+
+  if ( result <= 0 )
+    return false;
+
+  if ( poll_list[1].revents & POLLIN )
+    FTerm::clearSignalPipe();
+
+  if ( watcher && poll_list.size() > 2 )
+    watcher->setReadyEvents (&poll_list[2], poll_list.size() - 2);
+
+  return bool(poll_list[0].revents & (POLLIN | POLLHUP | POLLERR));
+}
+
+//----------------------------------------------------------------------
+uInt64 FKeyboard::getKeypressTimeoutDelay (uInt64 max_delay)
+{
+  // Returns the time (in µs) until the keypress timeout of the
+  // buffered input (or the timeout of an incomplete bracketed
+  // paste) is reached, but not more than max_delay
+
+  if ( key_fifo.isEmpty() && ! paste_active )
+    return max_delay;
 
-  FD_ZERO(&ifds);
-  FD_SET(stdin_no, &ifds);
-  tv.tv_sec  = 0;
-  tv.tv_usec = 100000;  // 100 ms
-  int result = select (stdin_no + 1, &ifds, 0, 0, &tv);
+  const uInt64 timeout = ( paste_active ) ? PASTE_TIMEOUT : key_timeout;
+  timeval now{};
+  FObject::getCurrentTime (&now);
+  const timeval diff = now - time_keypressed;
+  const uInt64 elapsed = uInt64(diff.tv_sec) * 1000000
+                       + uInt64(diff.tv_usec);
 
-  if ( result > 0 && FD_ISSET(stdin_no, &ifds) )
-    FD_CLR (stdin_no, &ifds);
+  if ( diff.tv_sec < 0 || elapsed > timeout )
+    return 0;
 
-  return ( result > 0 );
+  // isTimeout() expects a time span greater than the timeout
+  return std::min(timeout - elapsed + 1, max_delay);
 }
 
 //----------------------------------------------------------------------
@@ -137,10 +414,11 @@ void FKeyboard::clearKeyBuffer()
 {
   // Empty the buffer
 
-  fifo_offset = 0;
+  key_fifo.clear();
   key = 0;
   std::fill_n (fifo_buf, FIFO_BUF_SIZE, '\0');
-  fifo_in_use = false;
+  paste_data.clear();
+  paste_active = false;
 }
 
 //----------------------------------------------------------------------
@@ -148,7 +426,32 @@ void FKeyboard::clearKeyBufferOnTimeout()
 {
   // Empty the buffer on timeout
 
-  if ( fifo_in_use && isKeypressTimeout() )
+  if ( paste_active )
+  {
+    // The end marker of a bracketed paste is missing,
+    // the text received so far is delivered
+    if ( ! isPasteTimeout() )
+      return;
+
+    paste_data.append (key_fifo.getData(), key_fifo.getLength());
+    consumeInput (key_fifo.getLength());
+    finishPaste();
+    key = fc::Fkey_paste;
+    keyPressed();
+    keyReleased();
+    key = 0;
+    return;
+  }
+
+  if ( key_fifo.isEmpty() || ! isKeypressTimeout() )
+    return;
+
+  // A single escape character and keys that are the beginning
+  // of longer keys are complete after the timeout
+  escapeKeyHandling();
+
+  // Only an incomplete key sequence is discarded
+  if ( ! key_fifo.isEmpty() && isKeypressTimeout() )
     clearKeyBuffer();
 }
 
@@ -158,15 +461,14 @@ void FKeyboard::escapeKeyHandling()
   // Send an escape key press event if there is only one 0x1b
   // in the buffer and the timeout is reached
 
-  if ( fifo_in_use
-    && fifo_offset == 1
-    && fifo_buf[0] == 0x1b
-    && fifo_buf[1] == 0x00
+  if ( paste_active )
+    return;  // Escape characters belong to the pasted text
+
+  if ( key_fifo.getLength() == 1
+    && key_fifo.getData()[0] == 0x1b
     && isKeypressTimeout() )
   {
-    fifo_offset = 0;
-    fifo_buf[0] = 0x00;
-    fifo_in_use = false;
+    key_fifo.clear();
     input_data_pending = false;
     escapeKeyPressed();
   }
@@ -185,95 +487,153 @@ inline FKey FKeyboard::getMouseProtocolKey()
   if ( ! mouse_support )
     return NOT_SET;
 
-  std::size_t buf_len = std::strlen(fifo_buf);
+  const char* buf = key_fifo.getData();
+  const std::size_t buf_len = key_fifo.getLength();
+  std::size_t len{0};
+  const FKey keycode = getMouseReportLength(buf, buf_len, len);
 
-  // x11 mouse tracking
-  if ( buf_len >= 6 && fifo_buf[1] == '[' && fifo_buf[2] == 'M' )
-    return fc::Fkey_mouse;
+  if ( keycode == NOT_SET || len >= FIFO_BUF_SIZE )
+    return NOT_SET;
 
-  // SGR mouse tracking
-  if ( fifo_buf[1] == '[' && fifo_buf[2] == '<' && buf_len >= 9
-    && (fifo_buf[buf_len - 1] == 'M' || fifo_buf[buf_len - 1] == 'm') )
-    return fc::Fkey_extended_mouse;
+  // Directly following reports of the same protocol are passed on
+  // together, so that the mouse control can coalesce motion reports
+  std::size_t next_len{0};
 
-  // urxvt mouse tracking
-  if ( fifo_buf[1] == '[' && fifo_buf[2] >= '1' && fifo_buf[2] <= '9'
-    && fifo_buf[3] >= '0' && fifo_buf[3] <= '9' && buf_len >= 9
-    && fifo_buf[buf_len - 1] == 'M' )
-    return fc::Fkey_urxvt_mouse;
+  while ( len < buf_len
+       && getMouseReportLength(buf + len, buf_len - len, next_len) == keycode
+       && len + next_len < FIFO_BUF_SIZE )
+    len += next_len;
 
-  return NOT_SET;
+  // The mouse sequences are passed on in the key buffer
+  std::memcpy (fifo_buf, buf, len);
+  fifo_buf[len] = '\0';
+  consumeInput (len);
+  return keycode;
 }
 
 //----------------------------------------------------------------------
-inline FKey FKeyboard::getTermcapKey()
+FKey FKeyboard::getMouseReportLength ( const char buf[]
+                                     , std::size_t buf_len
+                                     , std::size_t& len )
 {
-  // Looking for termcap key strings in the buffer
+  // Returns the key code and the length of a complete mouse report
+  // at the beginning of buf
 
-  assert ( FIFO_BUF_SIZE > 0 );
-
-  if ( ! key_map )
+  if ( buf_len < 6 || buf[0] != ESC[0] || buf[1] != '[' )
     return NOT_SET;
 
-  for (std::size_t i{0}; key_map[i].tname[0] != 0; i++)
+  // Returns the length up to the final character or 0
+  auto sequenceLength = [buf, buf_len] (std::size_t start, bool sgr)
   {
-    char* k = key_map[i].string;
-    std::size_t len = ( k ) ? std::strlen(k) : 0;
-
-    if ( k && std::strncmp(k, fifo_buf, len) == 0 )  // found
+    for (std::size_t n{start}; n < buf_len; n++)
     {
-      std::size_t n{};
+      if ( buf[n] == 'M' || (sgr && buf[n] == 'm') )
+        return ( n + 1 >= 9 ) ? n + 1 : 0;
 
-      for (n = len; n < FIFO_BUF_SIZE; n++)  // Remove founded entry
-        fifo_buf[n - len] = fifo_buf[n];
+      if ( buf[n] != ';' && (buf[n] < '0' || buf[n] > '9') )
+        return std::size_t(0);
+    }
 
-      for (n = n - len; n < FIFO_BUF_SIZE; n++)  // Fill rest with '\0'
-        fifo_buf[n] = '\0';
+    return std::size_t(0);
+  };
 
-      input_data_pending = bool(fifo_buf[0] != '\0');
-      return fc::fkey[i].num;
-    }
+  FKey keycode{NOT_SET};
+  len = 0;
+
+  if ( buf[2] == 'M' )  // x11 mouse tracking
+  {
+    keycode = fc::Fkey_mouse;
+    len = 6;
+  }
+  else if ( buf[2] == '<' )  // SGR mouse tracking
+  {
+    keycode = fc::Fkey_extended_mouse;
+    len = sequenceLength(3, true);
+  }
+  else if ( buf[2] >= '1' && buf[2] <= '9'
+         && buf[3] >= '0' && buf[3] <= '9' )  // urxvt mouse tracking
+  {
+    keycode = fc::Fkey_urxvt_mouse;
+    len = sequenceLength(2, false);
   }
 
-  return NOT_SET;
+  if ( len == 0 )
+    return NOT_SET;
+
+  return keycode;
 }
 
 //----------------------------------------------------------------------
-inline FKey FKeyboard::getMetaKey()
+FKey FKeyboard::getBracketedPasteKey()
 {
-  // Looking for meta key strings in the buffer
+  // Collects the text between the bracketed paste markers.
+  // A long text can arrive with several reads.
 
-  assert ( FIFO_BUF_SIZE > 0 );
+  const char* buf = key_fifo.getData();
+  std::size_t len = key_fifo.getLength();
 
-  for (std::size_t i{0}; fc::fmetakey[i].string[0] != 0; i++)
+  if ( ! paste_active )
   {
-    char* kmeta = fc::fmetakey[i].string;  // The string is never null
-    std::size_t len = std::strlen(kmeta);
+    const std::size_t n = std::min(len, PASTE_MARKER_LEN);
 
-    if ( std::strncmp(kmeta, fifo_buf, len) == 0 )  // found
-    {
-      std::size_t n{};
+    if ( std::memcmp(buf, PASTE_BEGIN, n) != 0 )
+      return NOT_SET;
 
-      if ( len == 2 && ( fifo_buf[1] == 'O'
-                      || fifo_buf[1] == '['
-                      || fifo_buf[1] == ']' ) )
-      {
-        if ( ! isKeypressTimeout() )
-          return fc::need_more_data;
-      }
+    if ( n < PASTE_MARKER_LEN )  // Incomplete start marker
+      return ( isKeypressTimeout() ) ? NOT_SET : FKey(fc::need_more_data);
 
-      for (n = len; n < FIFO_BUF_SIZE; n++)  // Remove founded entry
-        fifo_buf[n - len] = fifo_buf[n];
+    consumeInput (PASTE_MARKER_LEN);
+    paste_data.clear();
+    paste_active = true;
+    buf = key_fifo.getData();
+    len = key_fifo.getLength();
+  }
 
-      for (n = n - len; n < FIFO_BUF_SIZE; n++)  // Fill rest with '\0'
-        fifo_buf[n] = '\0';
+  const char* end = std::search ( buf, buf + len
+                                , PASTE_END, PASTE_END + PASTE_MARKER_LEN );
 
-      input_data_pending = bool(fifo_buf[0] != '\0');
-      return fc::fmetakey[i].num;
-    }
+  if ( end == buf + len )
+  {
+    // Keeps a possibly incomplete end marker in the buffer
+    std::size_t keep = std::min(len, PASTE_MARKER_LEN - 1);
+
+    while ( keep > 0 && std::memcmp(buf + len - keep, PASTE_END, keep) != 0 )
+      keep--;
+
+    paste_data.append (buf, len - keep);
+    consumeInput (len - keep);
+    return fc::need_more_data;
   }
 
-  return NOT_SET;
+  const auto text_len = std::size_t(end - buf);
+  paste_data.append (buf, text_len);
+  consumeInput (text_len + PASTE_MARKER_LEN);
+  finishPaste();
+  return fc::Fkey_paste;
+}
+
+//----------------------------------------------------------------------
+inline FKey FKeyboard::getSequenceKey()
+{
+  // Looking for termcap and meta key strings in the buffer
+
+  const auto found = key_trie.match(key_fifo.getData(), key_fifo.getLength());
+
+  if ( found.type == FKeyTrie::no_match )
+    return NOT_SET;
+
+  if ( found.type == FKeyTrie::prefix_match )
+  {
+    // Waits for the rest of a longer key until the keypress timeout
+    if ( ! isKeypressTimeout() )
+      return fc::need_more_data;
+
+    if ( found.length == 0 )
+      return NOT_SET;
+  }
+
+  consumeInput (found.length);
+  return found.num;
 }
 
 //----------------------------------------------------------------------
@@ -281,9 +641,9 @@ inline FKey FKeyboard::getSingleKey()
 {
   // Looking for single key code in the buffer
 
-  std::size_t n{};
+  const char* buf = key_fifo.getData();
   std::size_t len{1};
-  uChar firstchar = uChar(fifo_buf[0]);
+  uChar firstchar = uChar(buf[0]);
   FKey keycode{};
 
   // Look for a utf-8 character
@@ -298,21 +658,24 @@ inline FKey FKeyboard::getSingleKey()
     else if ( (firstchar & 0xf8) == 0xf0 )
       len = 4;
 
+    // The rest of the character may follow with the next read
+    if ( len > key_fifo.getLength() )
+    {
+      if ( ! isKeypressTimeout() )
+        return fc::need_more_data;
+
+      len = key_fifo.getLength();
+    }
+
     for (std::size_t i{0}; i < len ; i++)
-      utf8char[i] = char(fifo_buf[i] & 0xff);
+      utf8char[i] = char(buf[i] & 0xff);
 
     keycode = UTF8decode(utf8char);
   }
   else
-    keycode = uChar(fifo_buf[0] & 0xff);
-
-  for (n = len; n < FIFO_BUF_SIZE; n++)  // Remove the key from the buffer front
-    fifo_buf[n - len] = fifo_buf[n];
+    keycode = uChar(buf[0] & 0xff);
 
-  for (n = n - len; n < FIFO_BUF_SIZE; n++)  // Fill the rest with '\0' bytes
-    fifo_buf[n] = '\0';
-
-  input_data_pending = bool(fifo_buf[0] != '\0');
+  consumeInput (len);
 
   if ( keycode == 0 )  // Ctrl+Space or Ctrl+@
     keycode = fc::Fckey_space;
@@ -350,6 +713,98 @@ bool FKeyboard::isKeypressTimeout()
   return FObject::isTimeout (&time_keypressed, key_timeout);
 }
 
+//----------------------------------------------------------------------
+bool FKeyboard::isPasteTimeout()
+{
+  return FObject::isTimeout (&time_keypressed, PASTE_TIMEOUT);
+}
+
+//----------------------------------------------------------------------
+void FKeyboard::buildKeyTrie()
+{
+  // Compiles the key strings into a trie. Termcap keys take
+  // precedence over meta keys with the same string.
+
+  key_trie.clear();
+
+  if ( key_map )
+  {
+    for (std::size_t i{0}; key_map[i].tname[0] != 0; i++)
+    {
+      const char* k = key_map[i].string;
+
+      // Only escape sequences are decoded via the trie
+      if ( k && k[0] == ESC[0] )
+        key_trie.insert (k, key_map[i].num);
+    }
+  }
+
+  for (std::size_t i{0}; fc::fmetakey[i].string[0] != 0; i++)
+    key_trie.insert (fc::fmetakey[i].string, fc::fmetakey[i].num);
+}
+
+//----------------------------------------------------------------------
+inline void FKeyboard::consumeInput (std::size_t len)
+{
+  // Removes a decoded key from the buffer front
+
+  key_fifo.consume (len);
+  input_data_pending = ! key_fifo.isEmpty();
+}
+
+//----------------------------------------------------------------------
+void FKeyboard::finishPaste()
+{
+  // Converts the received bytes into the paste text. Terminals
+  // transmit line breaks as carriage return.
+
+  std::wstring text{};
+  const std::size_t size = paste_data.length();
+  std::size_t i{0};
+  text.reserve(size);
+
+  while ( i < size )
+  {
+    const uChar firstchar = uChar(paste_data[i]);
+    std::size_t len{1};
+    wchar_t ch{};
+
+    if ( utf8_input && (firstchar & 0xc0) == 0xc0 )
+    {
+      char utf8char[5]{};  // Init array with '\0'
+
+      if ( (firstchar & 0xe0) == 0xc0 )
+        len = 2;
+      else if ( (firstchar & 0xf0) == 0xe0 )
+        len = 3;
+      else if ( (firstchar & 0xf8) == 0xf0 )
+        len = 4;
+
+      len = std::min(len, size - i);
+      std::memcpy (utf8char, paste_data.data() + i, len);
+      ch = wchar_t(UTF8decode(utf8char));
+    }
+    else
+      ch = wchar_t(firstchar);
+
+    i += len;
+
+    if ( ch == L'\r' )
+    {
+      if ( i < size && paste_data[i] == '\n' )
+        i++;
+
+      ch = L'\n';
+    }
+
+    text.push_back(ch);
+  }
+
+  paste_text = text;
+  paste_data.clear();
+  paste_active = false;
+}
+
 //----------------------------------------------------------------------
 FKey FKeyboard::UTF8decode (const char utf8[])
 {
@@ -403,7 +858,7 @@ FKey FKeyboard::UTF8decode (const char utf8[])
 inline ssize_t FKeyboard::readKey()
 {
   setNonBlockingInput();
-  ssize_t bytes = read(FTermios::getStdIn(), &read_buf, READ_BUF_SIZE - 1);
+  ssize_t bytes = read(FTermios::getStdIn(), &read_buf, READ_BUF_SIZE);
   unsetNonBlockingInput();
   return bytes;
 }
@@ -412,54 +867,49 @@ inline ssize_t FKeyboard::readKey()
 void FKeyboard::parseKeyBuffer()
 {
   ssize_t bytesread{};
-  FObject::getCurrentTime (&time_keypressed);
 
   while ( (bytesread = readKey()) > 0 )
   {
-    if ( bytesread + fifo_offset <= int(FIFO_BUF_SIZE) )
-    {
-      for (std::size_t i{0}; i < std::size_t(bytesread); i++)
-      {
-        fifo_buf[fifo_offset] = read_buf[i];
-        fifo_offset++;
-      }
-
-      fifo_in_use = true;
-    }
-
-    // Read the rest from the fifo buffer
-    while ( ! isKeypressTimeout()
-         && fifo_offset > 0
-         && key != fc::need_more_data )
-    {
-      key = parseKeyString();
-      key = keyCorrection(key);
+    // The keypress timeout starts with the last received data
+    FObject::getCurrentTime (&time_keypressed);
+    key_fifo.append (read_buf, std::size_t(bytesread));
+    decodeKeyBuffer();
+  }
+}
 
-      if ( key != fc::need_more_data )
-        keyPressed();
+//----------------------------------------------------------------------
+void FKeyboard::decodeKeyBuffer()
+{
+  // Decode all complete keys of the buffer. Only an incomplete
+  // key at the end of the buffer waits for more data.
 
-      fifo_offset = int(std::strlen(fifo_buf));
+  while ( ! key_fifo.isEmpty() && key != fc::need_more_data )
+  {
+    key = parseKeyString();
+    key = keyCorrection(key);
 
-      if ( key == fc::Fkey_mouse
-        || key == fc::Fkey_extended_mouse
-        || key == fc::Fkey_urxvt_mouse )
-        break;
+    if ( key != fc::need_more_data )
+    {
+      keyPressed();
+      // The processing time of a key does not count as waiting time
+      FObject::getCurrentTime (&time_keypressed);
     }
-
-    // Send key up event
-    if ( key > 0 )
-      keyReleased();
-
-    key = 0;
   }
 
-  std::fill_n (read_buf, READ_BUF_SIZE, '\0');
+  // Send key up event
+  if ( key > 0 )
+    keyReleased();
+
+  key = 0;
 }
 
 //----------------------------------------------------------------------
 FKey FKeyboard::parseKeyString()
 {
-  uChar firstchar = uChar(fifo_buf[0]);
+  if ( paste_active )
+    return getBracketedPasteKey();
+
+  uChar firstchar = uChar(key_fifo.getData()[0]);
 
   if ( firstchar == ESC[0] )
   {
@@ -468,12 +918,12 @@ FKey FKeyboard::parseKeyString()
     if ( keycode != NOT_SET )
       return keycode;
 
-    keycode = getTermcapKey();
+    keycode = getBracketedPasteKey();
 
     if ( keycode != NOT_SET )
       return keycode;
 
-    keycode = getMetaKey();
+    keycode = getSequenceKey();
 
     if ( keycode != NOT_SET )
       return keycode;
@@ -505,30 +955,31 @@ FKey FKeyboard::keyCorrection (const FKey& keycode)
 //----------------------------------------------------------------------
 void FKeyboard::substringKeyHandling()
 {
-  // Some keys (Meta-O, Meta-[, Meta-]) used substrings
+  // Some keys (e.g. Meta-O, Meta-[, Meta-]) are substrings
   // of other keys and are only processed after a timeout
 
-  if ( fifo_in_use
-    && fifo_offset == 2
-    && fifo_buf[0] == 0x1b
-    && (fifo_buf[1] == 'O' || fifo_buf[1] == '[' || fifo_buf[1] == ']')
-    && fifo_buf[2] == '\0'
-    && isKeypressTimeout() )
-  {
-    fifo_offset = 0;
-    fifo_buf[0] = 0x00;
-    fifo_in_use = false;
-    input_data_pending = false;
+  const std::size_t len = key_fifo.getLength();
 
-    if ( fifo_buf[1] == 'O' )
-      key = fc::Fmkey_O;
-    else if ( fifo_buf[1] == '[' )
-      key = fc::Fmkey_left_square_bracket;
-    else
-      key = fc::Fmkey_right_square_bracket;
+  if ( len < 2
+    || key_fifo.getData()[0] != ESC[0]
+    || ! isKeypressTimeout() )
+    return;
 
-    keyPressed();
-    keyReleased();
+  const auto found = key_trie.match(key_fifo.getData(), len);
+
+  if ( found.type != FKeyTrie::prefix_match || found.length == 0 )
+    return;
+
+  consumeInput (found.length);
+  key = found.num;
+  keyPressed();
+  keyReleased();
+
+  // The input after the key has already arrived
+  if ( ! key_fifo.isEmpty() )
+  {
+    FObject::getCurrentTime (&time_keypressed);
+    decodeKeyBuffer();
   }
 }
 
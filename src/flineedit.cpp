@@ -24,6 +24,7 @@
 
 #include "final/fapplication.h"
 #include "final/fevent.h"
+#include "final/fkeyboard.h"
 #include "final/flabel.h"
 #include "final/flineedit.h"
 #include "final/fpoint.h"
@@ -335,6 +336,20 @@ void FLineEdit::onKeyPress (FKeyEvent* ev)
   }
 }
 
+//----------------------------------------------------------------------
+void FLineEdit::onPaste (FPasteEvent* ev)
+{
+  // The pasted text is inserted in one step with a single redraw
+
+  if ( pasteInput(ev->getText()) )
+  {
+    drawInputField();
+    updateTerminal();
+  }
+
+  ev->accept();
+}
+
 //----------------------------------------------------------------------
 void FLineEdit::onMouseDown (FMouseEvent* ev)
 {
@@ -1043,6 +1058,66 @@ inline bool FLineEdit::keyInput (FKey key)
     return false;
 }
 
+//----------------------------------------------------------------------
+bool FLineEdit::pasteInput (const FString& str)
+{
+  // Line breaks and other C0 or C1 control characters are skipped
+
+  std::wstring input{};
+  std::wregex filter{};
+  const bool has_filter = ! input_filter.empty();
+
+  if ( has_filter )
+    filter.assign(input_filter);
+
+  for (auto&& ch : str)
+  {
+    if ( FKeyboard::isControlCharacter(ch) || ch > 0x10fff )
+      continue;
+
+    const wchar_t character[2]{ch, L'\0'};
+
+    if ( has_filter && ! regex_match(character, filter) )
+      continue;
+
+    input.push_back(ch);
+  }
+
+  if ( input.empty() )
+    return false;
+
+  auto len = text.getLength();
+
+  if ( cursor_pos > len )
+    cursor_pos = len;
+
+  // Overtyped characters do not increase the text length
+  const std::size_t end = ( insert_mode ) ? len : cursor_pos;
+  const std::size_t space = ( max_length > end ) ? max_length - end : 0;
+
+  if ( input.length() > space )
+  {
+    beep();
+    input.resize(space);
+
+    if ( input.empty() )
+      return false;
+  }
+
+  if ( cursor_pos == len )
+    text += input;
+  else if ( insert_mode )
+    text.insert(input, cursor_pos);
+  else
+    text.overwrite(input, cursor_pos);
+
+  cursor_pos += input.length();
+  print_text = ( isPasswordField() ) ? getPasswordText() : text;
+  adjustTextOffset();
+  processChanged();
+  return true;
+}
+
 //----------------------------------------------------------------------
 inline wchar_t FLineEdit::characterFilter (const wchar_t c)
 {
@@ -1066,13 +1141,15 @@ void FLineEdit::processActivate()
     redraw();
   }
 
-  emitCallback("activate");
+  static const FSignalId activate = getSignalId("activate");
+  emitCallback(activate);
 }
 
 //----------------------------------------------------------------------
 void FLineEdit::processChanged()
 {
-  emitCallback("changed");
+  static const FSignalId changed = getSignalId("changed");
+  emitCallback(changed);
 }
 
 }  // namespace finalcut
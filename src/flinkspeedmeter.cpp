@@ -0,0 +1,117 @@
+/***********************************************************************
+* flinkspeedmeter.cpp - Measures the throughput of the terminal link   *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <sys/ioctl.h>
+
+#include "final/flinkspeedmeter.h"
+#include "final/fobject.h"
+#include "final/fsystem.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FLinkSpeedMeter
+//----------------------------------------------------------------------
+
+// public methods of FLinkSpeedMeter
+//----------------------------------------------------------------------
+bool FLinkSpeedMeter::measure ( std::size_t written, uInt64 write_time
+                              , const timeval& now )
+{
+  // Estimates the terminal throughput from the output that was
+  // drained from the terminal output queue. Only intervals in which
+  // the link was busy all the time give a sample, an idle terminal
+  // would otherwise appear as a slow link.
+  // Returns false if the output queue was not checked this time.
+
+  static constexpr uInt64 min_blocking_time = 1000;  // 1 ms
+  static constexpr uInt64 sample_interval = 100000;  // 100 ms
+  const bool blocked = bool(written > 0 && write_time >= min_blocking_time);
+  const timeval diff = now - last_sample;
+  const uInt64 elapsed = uInt64(diff.tv_sec) * 1000000
+                       + uInt64(diff.tv_usec);
+  bytes_since_sample += written;
+
+  // Limits the output queue queries to one per sample interval
+  if ( ! blocked && diff.tv_sec >= 0 && elapsed < sample_interval )
+    return false;
+
+  const uInt backlog = queryOutputBacklog();
+  uInt64 sample{0};
+
+  // The queue can also grow by output that was not counted here
+  // (e.g. stdio output or another writer on the same terminal)
+  if ( output_backlog > 0 && backlog > bytes_since_sample
+    && output_backlog + bytes_since_sample >= backlog )
+  {
+    // Output from before the last sample is still queued,
+    // so the output queue was never empty in the meantime
+    const uInt64 drained = output_backlog + bytes_since_sample - backlog;
+
+    if ( diff.tv_sec >= 0 && elapsed > 0 )
+      sample = drained * 1000000 / elapsed;
+  }
+  else if ( output_backlog > 0 && blocked
+         && backlog > 0 && written > backlog )
+  {
+    // write() waited for space in the full output queue,
+    // so the link was busy during the write
+    sample = (written - backlog) * 1000000 / write_time;
+  }
+
+  output_backlog = backlog;
+  last_sample = now;
+  bytes_since_sample = 0;
+
+  if ( sample > 0 )
+  {
+    if ( link_speed == 0 )
+      link_speed = sample;
+    else
+      link_speed = (7 * link_speed + sample) / 8;
+  }
+
+  congested = blocked || sample > 0;
+  return true;
+}
+
+
+// private methods of FLinkSpeedMeter
+//----------------------------------------------------------------------
+uInt FLinkSpeedMeter::queryOutputBacklog()
+{
+  // Returns the number of bytes in the terminal output queue
+
+#if defined(TIOCOUTQ)
+  int queued{0};
+
+  if ( fsystem
+    && fsystem->ioctl (output_fd, TIOCOUTQ, &queued) == 0
+    && queued > 0 )
+    return uInt(queued);
+#endif
+
+  return 0;
+}
+
+}  // namespace finalcut
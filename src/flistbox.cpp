@@ -1694,19 +1694,22 @@ inline bool FListBox::keyIncSearchInput (FKey key)
 //----------------------------------------------------------------------
 void FListBox::processClick()
 {
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 //----------------------------------------------------------------------
 void FListBox::processSelect()
 {
-  emitCallback("row-selected");
+  static const FSignalId row_selected = getSignalId("row-selected");
+  emitCallback(row_selected);
 }
 
 //----------------------------------------------------------------------
 void FListBox::processChanged()
 {
-  emitCallback("row-changed");
+  static const FSignalId row_changed = getSignalId("row-changed");
+  emitCallback(row_changed);
 }
 
 //----------------------------------------------------------------------
@@ -2236,13 +2236,15 @@ void FListView::processClick()
   if ( itemlist.empty() )
     return;
 
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 //----------------------------------------------------------------------
 void FListView::processChanged()
 {
-  emitCallback("row-changed");
+  static const FSignalId row_changed = getSignalId("row-changed");
+  emitCallback(row_changed);
 }
 
 //----------------------------------------------------------------------
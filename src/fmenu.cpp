@@ -1573,7 +1573,8 @@ inline void FMenu::closeMenu()
 //----------------------------------------------------------------------
 void FMenu::processActivate()
 {
-  emitCallback("activate");
+  static const FSignalId activate = getSignalId("activate");
+  emitCallback(activate);
 }
 
 }  // namespace finalcut
@@ -569,13 +569,15 @@ void FMenuItem::updateSuperMenuDimensions()
 //----------------------------------------------------------------------
 void FMenuItem::processActivate()
 {
-  emitCallback("activate");
+  static const FSignalId activate = getSignalId("activate");
+  emitCallback(activate);
 }
 
 //----------------------------------------------------------------------
 void FMenuItem::processDeactivate()
 {
-  emitCallback("deactivate");
+  static const FSignalId deactivate = getSignalId("deactivate");
+  emitCallback(deactivate);
 }
 
 //----------------------------------------------------------------------
@@ -709,7 +711,8 @@ void FMenuItem::cb_destroyDialog (FWidget* widget, FDataPtr)
 //----------------------------------------------------------------------
 void FMenuItem::processClicked()
 {
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 }  // namespace finalcut
@@ -38,6 +38,36 @@
 namespace finalcut
 {
 
+namespace
+{
+
+// Returns the button parameter of a SGR or urxvt mouse report
+// and points p to the following character
+int getButtonParameter (const char*& p)
+{
+  int btn{0};
+
+  while ( *p >= '0' && *p <= '9' )
+  {
+    btn = 10 * btn + (*p - '0');
+    p++;
+  }
+
+  return btn;
+}
+
+// Returns the final character of a SGR or urxvt mouse report
+char getFinalCharacter (const char* p)
+{
+  while ( *p && *p != 'M' && *p != 'm' )
+    p++;
+
+  return *p;
+}
+
+}  // anonymous namespace
+
+
 //----------------------------------------------------------------------
 // class FMouse
 //----------------------------------------------------------------------
@@ -177,6 +207,15 @@ inline bool FMouse::isInputDataPending()
   return input_data_pending;
 }
 
+//----------------------------------------------------------------------
+bool FMouse::hasRepeatedMotion (const FKeyboard::keybuffer&)
+{
+  // Returns true if the next report in the buffer only moves
+  // the pointer with the button state of the current report
+
+  return false;
+}
+
 //----------------------------------------------------------------------
 inline FMouse* FMouse::createMouseObject (mouse_type mt)
 {
@@ -566,6 +605,23 @@ bool FMouseX11::hasData()
   return bool(x11_mouse[0]);
 }
 
+//----------------------------------------------------------------------
+bool FMouseX11::hasRepeatedMotion (const FKeyboard::keybuffer& fifo_buf)
+{
+  const int btn = uChar(x11_mouse[0]);
+
+  // Motion without a rolled wheel
+  if ( ! hasData() || (btn & button_up) != button1_pressed_move )
+    return false;
+
+  return fifo_buf[0] == ESC[0]
+      && fifo_buf[1] == '['
+      && fifo_buf[2] == 'M'
+      && uChar(fifo_buf[3]) == btn
+      && fifo_buf[4] != '\0'
+      && fifo_buf[5] != '\0';
+}
+
 //----------------------------------------------------------------------
 void FMouseX11::setRawData (FKeyboard::keybuffer& fifo_buf)
 {
@@ -744,6 +800,29 @@ bool FMouseSGR::hasData()
   return bool(sgr_mouse[0]);
 }
 
+//----------------------------------------------------------------------
+bool FMouseSGR::hasRepeatedMotion (const FKeyboard::keybuffer& fifo_buf)
+{
+  if ( ! hasData() )
+    return false;
+
+  const char* p = sgr_mouse;
+  const int btn = getButtonParameter(p);
+
+  // Motion without a rolled wheel
+  if ( *p != ';' || (btn & (button_up | button1_move)) != button1_move )
+    return false;
+
+  if ( fifo_buf[0] != ESC[0] || fifo_buf[1] != '[' || fifo_buf[2] != '<' )
+    return false;
+
+  const char* next = fifo_buf + 3;
+
+  return getButtonParameter(next) == btn
+      && *next == ';'
+      && getFinalCharacter(next) == getFinalCharacter(p);
+}
+
 //----------------------------------------------------------------------
 void FMouseSGR::setRawData (FKeyboard::keybuffer& fifo_buf)
 {
@@ -973,6 +1052,29 @@ bool FMouseUrxvt::hasData()
   return bool(urxvt_mouse[0]);
 }
 
+//----------------------------------------------------------------------
+bool FMouseUrxvt::hasRepeatedMotion (const FKeyboard::keybuffer& fifo_buf)
+{
+  if ( ! hasData() )
+    return false;
+
+  const char* p = urxvt_mouse;
+  const int btn = getButtonParameter(p);
+
+  // Motion without a rolled wheel
+  if ( *p != ';' || (btn & button_up) != button1_pressed_move )
+    return false;
+
+  if ( fifo_buf[0] != ESC[0] || fifo_buf[1] != '[' )
+    return false;
+
+  const char* next = fifo_buf + 2;
+
+  return getButtonParameter(next) == btn
+      && *next == ';'
+      && getFinalCharacter(next) == 'M';
+}
+
 //----------------------------------------------------------------------
 void FMouseUrxvt::setRawData (FKeyboard::keybuffer& fifo_buf)
 {
@@ -1478,6 +1580,16 @@ bool FMouseControl::isInputDataPending()
                      );
 }
 
+//----------------------------------------------------------------------
+bool FMouseControl::isInputDataPending (FMouse::mouse_type mt)
+{
+  const auto& iter = mouse_protocol.find(mt);
+
+  return iter != mouse_protocol.end()
+      && iter->second
+      && iter->second->isInputDataPending();
+}
+
 //----------------------------------------------------------------------
 #ifdef F_HAVE_LIBGPM
 bool FMouseControl::isGpmMouseEnabled()
@@ -1541,9 +1653,21 @@ void FMouseControl::setRawData ( FMouse::mouse_type mt
                                , FKeyboard::keybuffer& fifo_buf)
 {
   auto mouse = mouse_protocol[mt];
+  coalesced_moves = 0;
+
+  if ( ! mouse )
+    return;
+
+  mouse->setRawData (fifo_buf);
 
-  if ( mouse )
+  // Queued motion reports with an unchanged button state are
+  // coalesced, only the latest pointer position is processed
+  while ( mouse->isInputDataPending()
+       && mouse->hasRepeatedMotion(fifo_buf) )
+  {
     mouse->setRawData (fifo_buf);
+    coalesced_moves++;
+  }
 }
 
 //----------------------------------------------------------------------
@@ -20,9 +20,12 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
+#include <algorithm>
+#include <ctime>
 #include <memory>
 
 #include "final/emptyfstring.h"
+#include "final/fapplication.h"
 #include "final/fevent.h"
 #include "final/fc.h"
 #include "final/fobject.h"
@@ -74,6 +77,9 @@ FObject::~FObject()  // destructor
 {
   delOwnTimer();  // Delete all timers of this object
 
+  // Delete all events and task results for this object
+  FApplication::removeQueuedEvent(this);
+
   if ( ! has_parent && timer_list )
   {
     delete timer_list;
@@ -212,7 +218,20 @@ bool FObject::event (FEvent* ev)
 //----------------------------------------------------------------------
 void FObject::getCurrentTime (timeval* time)
 {
-  // Get the current time as timeval struct
+  // Get the current time of the monotonic clock as timeval struct.
+  // Unlike the wall-clock time, it does not jump when the system
+  // time is changed.
+
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts{};
+
+  if ( clock_gettime(CLOCK_MONOTONIC, &ts) == 0 )
+  {
+    time->tv_sec = ts.tv_sec;
+    time->tv_usec = suseconds_t(ts.tv_nsec / 1000);
+    return;
+  }
+#endif
 
   gettimeofday(time, 0);
 
@@ -266,49 +285,16 @@ int FObject::addTimer (int interval)
   // Create a timer and returns the timer identifier number
   // (interval in ms)
 
-  timeval time_interval{};
-  timeval currentTime{};
-  int id{1};
-  timer_modify_lock = true;
-
-  // find an unused timer id
-  if ( ! timer_list->empty() )
-  {
-    auto iter = timer_list->begin();
-    auto last = timer_list->end();
-
-    while ( iter != last )
-    {
-      if ( iter->id == id )
-      {
-        iter = timer_list->begin();
-        id++;
-        continue;
-      }
-      ++iter;
-    }
-  }
-
-  if ( id <= 0 || id > int(timer_list->size() + 1) )
-    return 0;
-
-  time_interval.tv_sec  =  interval / 1000;
-  time_interval.tv_usec = (interval % 1000) * 1000;
-  getCurrentTime (&currentTime);
-  timeval timeout = currentTime + time_interval;
-  FTimerData t{ id, time_interval, timeout, this };
-
-  // insert in list sorted by timeout
-  auto iter = timer_list->begin();
-  auto last = timer_list->end();
-
-  while ( iter != last && iter->timeout < t.timeout )
-    ++iter;
+  return insertTimer (interval, false);
+}
 
-  timer_list->insert (iter, t);
-  timer_modify_lock = false;
+//----------------------------------------------------------------------
+int FObject::addOneShotTimer (int interval)
+{
+  // Create a timer that expires only once and
+  // returns the timer identifier number (interval in ms)
 
-  return id;
+  return insertTimer (interval, true);
 }
 
 //----------------------------------------------------------------------
@@ -316,25 +302,13 @@ bool FObject::delTimer (int id)
 {
   // Deletes a timer by using the timer identifier number
 
-  if ( id <= 0 )
+  if ( id <= 0 || ! timer_list )
     return false;
 
   timer_modify_lock = true;
-  auto iter = timer_list->begin();
-  auto last = timer_list->end();
-
-  while ( iter != last && iter->id != id )
-    ++iter;
-
-  if ( iter != last )
-  {
-    timer_list->erase(iter);
-    timer_modify_lock = false;
-    return true;
-  }
-
+  bool deleted = timer_list->erase(id);
   timer_modify_lock = false;
-  return false;
+  return deleted;
 }
 
 //----------------------------------------------------------------------
@@ -349,16 +323,7 @@ bool FObject::delOwnTimer()
     return false;
 
   timer_modify_lock = true;
-  auto iter = timer_list->begin();
-
-  while ( iter != timer_list->end() )
-  {
-    if ( iter->object == this )
-      iter = timer_list->erase(iter);
-    else
-      ++iter;
-  }
-
+  timer_list->erase(this);
   timer_modify_lock = false;
   return true;
 }
@@ -376,7 +341,6 @@ bool FObject::delAllTimer()
 
   timer_modify_lock = true;
   timer_list->clear();
-  timer_list->shrink_to_fit();
   timer_modify_lock = false;
   return true;
 }
@@ -391,6 +355,28 @@ void FObject::onTimer (FTimerEvent*)
 void FObject::onUserEvent (FUserEvent*)
 { }
 
+//----------------------------------------------------------------------
+uInt64 FObject::getNextTimerDelay (uInt64 max_delay) const
+{
+  // Returns the time (in µs) until the next timer expires,
+  // but not more than max_delay
+
+  if ( ! timer_list || timer_list->empty() )
+    return max_delay;
+
+  timeval currentTime{};
+  getCurrentTime (&currentTime);
+  const timeval& timeout = timer_list->top().timeout;
+
+  if ( ! (currentTime < timeout) )  // Timer expired
+    return 0;
+
+  const timeval diff = timeout - currentTime;
+  const uInt64 delay = uInt64(diff.tv_sec) * 1000000
+                     + uInt64(diff.tv_usec);
+  return std::min(delay, max_delay);
+}
+
 //----------------------------------------------------------------------
 uInt FObject::processTimerEvent()
 {
@@ -408,28 +394,64 @@ uInt FObject::processTimerEvent()
   if ( timer_list->empty() )
     return 0;
 
-  for (auto&& timer : *timer_list)
+  // Timers that are rescheduled or added during this call get a
+  // higher sequence number. Each timer fires at most once per call.
+  const uInt64 first_new_sequence = timer_list->getSequence();
+
+  while ( ! timer_list->empty() )
   {
-    if ( ! timer.id
-      || ! timer.object
-      || currentTime < timer.timeout )  // no timer expired
-      break;
+    const FTimerData& timer = timer_list->top();
 
-    timer.timeout += timer.interval;
+    if ( currentTime < timer.timeout  // no timer expired
+      || timer.sequence >= first_new_sequence )
+      break;
 
-    if ( timer.timeout < currentTime )
-      timer.timeout = currentTime + timer.interval;
+    const int id = timer.id;
+    FObject* object = timer.object;
+    const timeval interval = timer.interval;
 
-    if ( timer.interval.tv_usec > 0 || timer.interval.tv_sec > 0 )
+    if ( interval.tv_usec > 0 || interval.tv_sec > 0 )
       activated++;
 
-    FTimerEvent t_ev(fc::Timer_Event, timer.id);
-    performTimerAction (timer.object, &t_ev);
+    if ( timer.one_shot )
+      timer_list->pop();
+    else
+    {
+      timeval timeout = timer.timeout + interval;
+
+      if ( timeout < currentTime )
+        timeout = currentTime + interval;
+
+      timer_list->reschedule(timeout);
+    }
+
+    FTimerEvent t_ev(fc::Timer_Event, id);
+    performTimerAction (object, &t_ev);
   }
 
   return activated;
 }
 
+// private methods of FObject
+//----------------------------------------------------------------------
+int FObject::insertTimer (int interval, bool one_shot)
+{
+  timeval time_interval{};
+  timeval currentTime{};
+
+  if ( ! timer_list )
+    return 0;
+
+  timer_modify_lock = true;
+  time_interval.tv_sec  =  interval / 1000;
+  time_interval.tv_usec = (interval % 1000) * 1000;
+  getCurrentTime (&currentTime);
+  timeval timeout = currentTime + time_interval;
+  int id = timer_list->insert (this, time_interval, timeout, one_shot);
+  timer_modify_lock = false;
+  return id;
+}
+
 //----------------------------------------------------------------------
 void FObject::performTimerAction (const FObject*, const FEvent*)
 { }
@@ -455,9 +455,18 @@ bool FOptiAttr::isNormal (FChar*& ch)
   return hasNoAttribute(ch) && ! hasColor(ch);
 }
 
+//----------------------------------------------------------------------
+bool FOptiAttr::isInvisibleSimulated (FChar*& ch)
+{
+  // Without a secure mode, invisible characters are shown as spaces
+  return ch->attr.bit.invisible && ! F_enter_secure_mode.cap;
+}
+
 //----------------------------------------------------------------------
 void FOptiAttr::initialize()
 {
+  clearAttributeCache();
+
   if ( max_color < 8 )
     monochron = true;
   else
@@ -544,22 +553,108 @@ FColor FOptiAttr::vga2ansi (FColor color)
 //----------------------------------------------------------------------
 char* FOptiAttr::changeAttribute (FChar*& term, FChar*& next)
 {
-  const bool next_has_color = hasColor(next);
-  fake_reverse = false;
   attr_buf[0] = '\0';
 
   if ( ! (term && next) )
     return attr_buf;
 
+  // Repeated transitions are taken from the cache
+  auto& cached = getCachedTransition(term, next);
+
+  if ( cached.valid )
+  {
+    cache_hits++;
+    term->fg_color = cached.term_fg;
+    term->bg_color = cached.term_bg;
+    term->attr.byte[0] = cached.term_attr[0];
+    term->attr.byte[1] = cached.term_attr[1];
+    next->fg_color = cached.next_fg;
+    next->bg_color = cached.next_bg;
+    next->attr.byte[0] = cached.next_attr[0];
+    next->attr.byte[1] = cached.next_attr[1];
+
+    if ( ! cached.changed )
+      return 0;
+
+    std::strcpy (attr_buf, cached.sequence);
+    return attr_buf;
+  }
+
+  cache_misses++;
+  char* attr_str = generateAttributeChange (term, next);
+
+  if ( attr_str && std::strlen(attr_str) >= sizeof(cached.sequence) )
+    return attr_str;  // Too long for the cache
+
+  cached.term_fg = term->fg_color;
+  cached.term_bg = term->bg_color;
+  cached.term_attr[0] = term->attr.byte[0];
+  cached.term_attr[1] = term->attr.byte[1];
+  cached.next_fg = next->fg_color;
+  cached.next_bg = next->bg_color;
+  cached.next_attr[0] = next->attr.byte[0];
+  cached.next_attr[1] = next->attr.byte[1];
+  cached.changed = bool(attr_str);
+
+  if ( attr_str )
+    std::strcpy (cached.sequence, attr_str);
+
+  cached.valid = true;
+  return attr_str;
+}
+
+
+// private methods of FOptiAttr
+//----------------------------------------------------------------------
+void FOptiAttr::clearAttributeCache()
+{
+  // Forgets all transitions after a change of the terminal capabilities
+
+  for (auto&& cached : transition_cache)
+    cached.valid = false;
+}
+
+//----------------------------------------------------------------------
+FOptiAttr::transition& FOptiAttr::getCachedTransition ( FChar*& term
+                                                      , FChar*& next )
+{
+  // Returns the cache entry for the transition from term to next.
+  // A valid entry with a different key is replaced (direct-mapped cache).
+
+  const uInt64 colors = uInt64(term->fg_color)
+                      | uInt64(term->bg_color) << 16
+                      | uInt64(next->fg_color) << 32
+                      | uInt64(next->bg_color) << 48;
+  const uInt32 attributes = uInt32(term->attr.byte[0])
+                          | uInt32(term->attr.byte[1]) << 8
+                          | uInt32(next->attr.byte[0]) << 16
+                          | uInt32(next->attr.byte[1]) << 24;
+  const uInt64 hash = ( colors
+                      ^ (uInt64(attributes) * 0xff51afd7ed558ccdULL) )
+                    * 0x9e3779b97f4a7c15ULL;
+  auto& cached = transition_cache[hash >> (64 - TRANSITION_CACHE_BITS)];
+
+  if ( cached.colors != colors || cached.attributes != attributes )
+  {
+    cached.colors = colors;
+    cached.attributes = attributes;
+    cached.valid = false;
+  }
+
+  return cached;
+}
+
+//----------------------------------------------------------------------
+char* FOptiAttr::generateAttributeChange (FChar*& term, FChar*& next)
+{
+  const bool next_has_color = hasColor(next);
+  fake_reverse = false;
+
   prevent_no_color_video_attributes (term, next_has_color);
   prevent_no_color_video_attributes (next);
   detectSwitchOn (term, next);
   detectSwitchOff (term, next);
 
-  // Simulate invisible characters
-  if ( ! F_enter_secure_mode.cap && next->attr.bit.invisible )
-    next->encoded_char = ' ';
-
   // Look for no changes
   if ( ! (switchOn() || switchOff() || hasColorChanged(term, next)) )
     return 0;
@@ -581,8 +676,6 @@ char* FOptiAttr::changeAttribute (FChar*& term, FChar*& next)
   return attr_buf;
 }
 
-
-// private methods of FOptiAttr
 //----------------------------------------------------------------------
 inline bool FOptiAttr::setTermBold (FChar*& term)
 {
@@ -60,8 +60,13 @@ void FOptiMove::setBaudRate (int baud)
 {
   assert ( baud >= 0 );
 
+  if ( baud == baudrate )
+    return;
+
   baudrate = baud;
   calculateCharDuration();
+  // The capability costs depend on the character duration
+  recalculateCapabilities();
 }
 
 //----------------------------------------------------------------------
@@ -266,9 +271,11 @@ void FOptiMove::set_cursor_right (char cap[])
 //----------------------------------------------------------------------
 void FOptiMove::set_cursor_address (char cap[])
 {
-  if ( cap )
+  // The capability is only used if tgoto() can expand it
+  char* temp = ( cap ) ? tgoto(cap, 23, 23) : nullptr;
+
+  if ( temp )
   {
-    char* temp = tgoto(cap, 23, 23);
     F_cursor_address.cap = cap;
     F_cursor_address.duration = capDuration (temp, 1);
     F_cursor_address.length = capDurationToLength (F_cursor_address.duration);
@@ -491,12 +498,13 @@ char* FOptiMove::moveCursor (int xold, int yold, int xnew, int ynew)
   check_boundaries (xold, yold, xnew, ynew);
 
   // Method 0: direct cursor addressing
-  if ( isMethod0Faster(move_time, xnew, ynew) )
+  if ( isMethod0Faster(move_time) )
   {
     if ( xold < 0
       || yold < 0
       || isWideMove (xold, yold, xnew, ynew) )
     {
+      moveByMethod (0, xold, yold, xnew, ynew);
       return ( move_time < LONG_DURATION ) ? move_buf : 0;
     }
   }
@@ -521,7 +529,7 @@ char* FOptiMove::moveCursor (int xold, int yold, int xnew, int ynew)
   if ( isMethod5Faster(move_time, yold, xnew, ynew) )
     method = 5;
 
-  // Copy the escape sequence for the chosen method in move_buf
+  // Only the escape sequence of the chosen method is built (in move_buf)
   moveByMethod (method, xold, yold, xnew, ynew);
 
   if ( move_time < LONG_DURATION )
@@ -548,6 +556,33 @@ void FOptiMove::calculateCharDuration()
     char_duration = 1;
 }
 
+//----------------------------------------------------------------------
+void FOptiMove::recalculateCapabilities()
+{
+  // Recalculates the duration and length of all set capabilities
+
+  set_cursor_home (F_cursor_home.cap);
+  set_cursor_to_ll (F_cursor_to_ll.cap);
+  set_carriage_return (F_carriage_return.cap);
+  set_tabular (F_tab.cap);
+  set_back_tab (F_back_tab.cap);
+  set_cursor_up (F_cursor_up.cap);
+  set_cursor_down (F_cursor_down.cap);
+  set_cursor_left (F_cursor_left.cap);
+  set_cursor_right (F_cursor_right.cap);
+  set_cursor_address (F_cursor_address.cap);
+  set_column_address (F_column_address.cap);
+  set_row_address (F_row_address.cap);
+  set_parm_up_cursor (F_parm_up_cursor.cap);
+  set_parm_down_cursor (F_parm_down_cursor.cap);
+  set_parm_left_cursor (F_parm_left_cursor.cap);
+  set_parm_right_cursor (F_parm_right_cursor.cap);
+  set_erase_chars (F_erase_chars.cap);
+  set_repeat_char (F_repeat_char.cap);
+  set_clr_bol (F_clr_bol.cap);
+  set_clr_eol (F_clr_eol.cap);
+}
+
 //----------------------------------------------------------------------
 int FOptiMove::capDuration (char cap[], int affcnt)
 {
@@ -668,6 +703,130 @@ int FOptiMove::relativeMove ( char move[]
   return vtime + htime;
 }
 
+//----------------------------------------------------------------------
+int FOptiMove::repeatedDuration ( const capability& o
+                                , int count
+                                , std::size_t dst_len )
+{
+  // Returns the duration of repeatedAppend() without building the string
+
+  std::size_t src_len = std::strlen(o.cap);
+
+  if ( (dst_len + uInt(count) * src_len) < BUF_SIZE - 1 )
+    return count * o.duration;
+  else
+    return LONG_DURATION;
+}
+
+//----------------------------------------------------------------------
+int FOptiMove::relativeMoveDuration ( int from_x, int from_y
+                                    , int to_x, int to_y )
+{
+  // Returns the duration of relativeMove() without building the string
+
+  int vtime{0};
+  int htime{0};
+
+  if ( to_y != from_y )  // vertical move
+  {
+    vtime = verticalMoveDuration (from_y, to_y);
+
+    if ( vtime >= LONG_DURATION )
+      return LONG_DURATION;
+  }
+
+  if ( to_x != from_x )  // horizontal move
+  {
+    htime = horizontalMoveDuration (from_x, to_x);
+
+    if ( htime >= LONG_DURATION )
+      return LONG_DURATION;
+  }
+
+  return vtime + htime;
+}
+
+//----------------------------------------------------------------------
+inline int FOptiMove::verticalMoveDuration (int from_y, int to_y)
+{
+  const bool down = ( to_y > from_y );
+  const auto& parm_cursor = ( down ) ? F_parm_down_cursor : F_parm_up_cursor;
+  const auto& cursor = ( down ) ? F_cursor_down : F_cursor_up;
+  const int num = std::abs(to_y - from_y);
+  int vtime{LONG_DURATION};
+
+  if ( F_row_address.cap )
+    vtime = F_row_address.duration;
+
+  if ( parm_cursor.cap && parm_cursor.duration < vtime )
+    vtime = parm_cursor.duration;
+
+  if ( cursor.cap && num * cursor.duration < vtime )
+    vtime = repeatedDuration (cursor, num);
+
+  return vtime;
+}
+
+//----------------------------------------------------------------------
+inline int FOptiMove::horizontalMoveDuration (int from_x, int to_x)
+{
+  const bool right = ( to_x > from_x );
+  const auto& parm_cursor = ( right ) ? F_parm_right_cursor
+                                      : F_parm_left_cursor;
+  const auto& cursor = ( right ) ? F_cursor_right : F_cursor_left;
+  const auto& tabulator = ( right ) ? F_tab : F_back_tab;
+  int htime{LONG_DURATION};
+
+  if ( F_column_address.cap )
+    htime = F_column_address.duration;
+
+  if ( parm_cursor.cap && parm_cursor.duration < htime )
+    htime = parm_cursor.duration;
+
+  if ( ! cursor.cap )
+    return htime;
+
+  int pos = from_x;
+  int tab_time{0};
+  std::size_t tab_len{0};
+
+  if ( tabstop > 0 && tabulator.cap )
+  {
+    // Number of tab stops between from_x and to_x
+    int tabs{0};
+
+    if ( right )
+    {
+      tabs = to_x / tabstop - from_x / tabstop;
+
+      if ( tabs > 0 )
+        pos = (to_x / tabstop) * tabstop;
+    }
+    else
+    {
+      int to_stop = (to_x + tabstop - 1) / tabstop;
+      tabs = (from_x + tabstop - 1) / tabstop - to_stop;
+
+      if ( tabs > 0 )
+        pos = to_stop * tabstop;
+    }
+
+    tab_len = uInt(tabs) * std::strlen(tabulator.cap);
+
+    if ( tab_len >= BUF_SIZE - 1 )
+      return htime;
+
+    tab_time = tabs * tabulator.duration;
+  }
+
+  int cursor_time = repeatedDuration (cursor, std::abs(to_x - pos), tab_len);
+
+  if ( cursor_time < LONG_DURATION && tab_time + cursor_time < htime )
+    htime = tab_time + cursor_time;
+
+  return htime;
+}
+
 //----------------------------------------------------------------------
 inline int FOptiMove::verticalMove (char move[], int from_y, int to_y)
 {
@@ -894,17 +1053,11 @@ inline bool FOptiMove::isWideMove ( int xold, int yold
 }
 
 //----------------------------------------------------------------------
-inline bool FOptiMove::isMethod0Faster ( int& move_time
-                                       , int xnew, int ynew )
+inline bool FOptiMove::isMethod0Faster (int& move_time)
 {
   // Test method 0: direct cursor addressing
-  char* move_xy = tgoto(F_cursor_address.cap, xnew, ynew);
-
-  if ( move_xy )
+  if ( F_cursor_address.cap )
   {
-    char* move_ptr = move_buf;
-    std::strncpy (move_ptr, move_xy, BUF_SIZE - 1);
-    move_ptr[BUF_SIZE - 1] = '\0';
     move_time = F_cursor_address.duration;
     return true;
   }
@@ -921,8 +1074,7 @@ inline bool FOptiMove::isMethod1Faster ( int& move_time
 
   if ( xold >= 0 && yold >= 0 )
   {
-    char null_result[BUF_SIZE];
-    int  new_time = relativeMove (null_result, xold, yold, xnew, ynew);
+    int new_time = relativeMoveDuration (xold, yold, xnew, ynew);
 
     if ( new_time < LONG_DURATION && new_time < move_time )
     {
@@ -943,8 +1095,7 @@ inline bool FOptiMove::isMethod2Faster ( int& move_time
 
   if ( yold >= 0 && F_carriage_return.cap )
   {
-    char null_result[BUF_SIZE];
-    int  new_time = relativeMove (null_result, 0, yold, xnew, ynew);
+    int new_time = relativeMoveDuration (0, yold, xnew, ynew);
 
     if ( new_time < LONG_DURATION
       && F_carriage_return.duration + new_time < move_time )
@@ -965,8 +1116,7 @@ inline bool FOptiMove::isMethod3Faster ( int& move_time
 
   if ( F_cursor_home.cap )
   {
-    char null_result[BUF_SIZE];
-    int  new_time = relativeMove (null_result, 0, 0, xnew, ynew);
+    int new_time = relativeMoveDuration (0, 0, xnew, ynew);
 
     if ( new_time < LONG_DURATION
       && F_cursor_home.duration + new_time < move_time )
@@ -986,10 +1136,8 @@ inline bool FOptiMove::isMethod4Faster ( int& move_time
   // Test method 4: home-down + local movement
   if ( F_cursor_to_ll.cap )
   {
-    char null_result[BUF_SIZE];
-    int  new_time = relativeMove ( null_result
-                                 , 0, int(screen_height) - 1
-                                 , xnew, ynew );
+    int new_time = relativeMoveDuration ( 0, int(screen_height) - 1
+                                       , xnew, ynew );
 
     if ( new_time < LONG_DURATION
       && F_cursor_to_ll.duration + new_time < move_time )
@@ -1013,10 +1161,8 @@ inline bool FOptiMove::isMethod5Faster ( int& move_time
     && yold > 0
     && F_cursor_left.cap )
   {
-    char null_result[BUF_SIZE];
-    int  new_time = relativeMove ( null_result
-                                 , int(screen_width) - 1, yold - 1
-                                 , xnew, ynew );
+    int new_time = relativeMoveDuration ( int(screen_width) - 1, yold - 1
+                                       , xnew, ynew );
 
     if ( new_time < LONG_DURATION
       && F_carriage_return.cap
@@ -1042,6 +1188,18 @@ void FOptiMove::moveByMethod ( int method
 
   switch ( method )
   {
+    case 0:
+    {
+      const char* move_xy = tgoto(F_cursor_address.cap, xnew, ynew);
+      move_ptr[0] = '\0';
+
+      if ( move_xy )
+        std::strncpy (move_ptr, move_xy, BUF_SIZE - 1);
+
+      move_ptr[BUF_SIZE - 1] = '\0';
+      break;
+    }
+
     case 1:
       relativeMove (move_ptr, xold, yold, xnew, ynew);
       break;
@@ -0,0 +1,225 @@
+/***********************************************************************
+* foutputwriter.cpp - Writes the terminal output in a separate thread  *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <chrono>
+#include <cstdio>
+
+#include "final/foutputwriter.h"
+#include "final/fsystem.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FOutputWriter
+//----------------------------------------------------------------------
+
+// constructors and destructor
+//----------------------------------------------------------------------
+FOutputWriter::~FOutputWriter()  // destructor
+{
+  stop();
+}
+
+
+// public methods of FOutputWriter
+//----------------------------------------------------------------------
+uInt64 FOutputWriter::getFrameCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return frame_count;
+}
+
+//----------------------------------------------------------------------
+uInt64 FOutputWriter::getMergedFrames() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return merged_frames;
+}
+
+//----------------------------------------------------------------------
+uInt64 FOutputWriter::getWrittenBytes() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return written_bytes;
+}
+
+//----------------------------------------------------------------------
+uInt64 FOutputWriter::getWriteStallTime() const
+{
+  // Returns the total time (in µs) the writer was blocked in write()
+  std::lock_guard<std::mutex> lock(mutex);
+  return write_stall_time;
+}
+
+//----------------------------------------------------------------------
+uInt64 FOutputWriter::getMaxWriteStallTime() const
+{
+  // Returns the longest time (in µs) needed to write one frame
+  std::lock_guard<std::mutex> lock(mutex);
+  return max_write_stall_time;
+}
+
+//----------------------------------------------------------------------
+bool FOutputWriter::isRunning() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return running;
+}
+
+//----------------------------------------------------------------------
+void FOutputWriter::start (FSystem* system, int fd)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if ( running || ! system )
+    return;
+
+  fsystem = system;
+  output_fd = fd;
+  running = true;
+  writer_thread = std::thread(&FOutputWriter::run, this);
+}
+
+//----------------------------------------------------------------------
+void FOutputWriter::stop()
+{
+  // Writes the remaining output and terminates the writer thread
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+
+  frame_ready.notify_one();
+
+  if ( writer_thread.joinable() )
+    writer_thread.join();
+}
+
+//----------------------------------------------------------------------
+void FOutputWriter::write (std::string& buffer)
+{
+  // Hands over the buffer content to the writer thread.
+  // A frame that has not yet been picked up by the writer
+  // is extended by the new output, because each frame only
+  // contains the changes relative to the previous one.
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( pending_frame.empty() )
+      pending_frame.swap(buffer);  // Exchange front and back buffer
+    else if ( ! buffer.empty() )
+    {
+      pending_frame.append(buffer);
+      merged_frames++;
+    }
+
+    buffer.clear();
+    stdio_pending = true;
+  }
+
+  frame_ready.notify_one();
+}
+
+//----------------------------------------------------------------------
+void FOutputWriter::waitForCompletion()
+{
+  // Blocks until all handed over output has been written
+
+  std::unique_lock<std::mutex> lock(mutex);
+  frame_written.wait ( lock
+                     , [this]
+                       {
+                         return ! writing
+                             && ! stdio_pending
+                             && pending_frame.empty();
+                       } );
+}
+
+
+// private methods of FOutputWriter
+//----------------------------------------------------------------------
+void FOutputWriter::run()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while ( true )
+  {
+    frame_ready.wait ( lock
+                     , [this]
+                       {
+                         return ! running
+                             || stdio_pending
+                             || ! pending_frame.empty();
+                       } );
+
+    if ( ! stdio_pending && pending_frame.empty() )
+      break;  // Stopped and nothing left to write
+
+    current_frame.swap(pending_frame);
+    stdio_pending = false;
+    writing = true;
+    lock.unlock();
+
+    // Output from the stdio stream (e.g. FTerm::putstring) comes first
+    std::fflush(stdout);
+    writeFrame();
+
+    lock.lock();
+    current_frame.clear();
+    writing = false;
+
+    if ( ! stdio_pending && pending_frame.empty() )
+      frame_written.notify_all();
+  }
+
+  frame_written.notify_all();
+}
+
+//----------------------------------------------------------------------
+void FOutputWriter::writeFrame()
+{
+  if ( current_frame.empty() )
+    return;
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  using std::chrono::steady_clock;
+
+  const auto start = steady_clock::now();
+  const std::size_t written = fsystem->writeAll ( output_fd
+                                                , current_frame.data()
+                                                , current_frame.length() );
+  const auto duration = steady_clock::now() - start;
+  const auto stall_time = uInt64(duration_cast<microseconds>(duration).count());
+  std::lock_guard<std::mutex> lock(mutex);
+  frame_count++;
+  written_bytes += written;
+  write_stall_time += stall_time;
+
+  if ( stall_time > max_write_stall_time )
+    max_write_stall_time = stall_time;
+}
+
+}  // namespace finalcut
@@ -77,7 +77,8 @@ void FRadioMenuItem::init (FWidget* parent)
 //----------------------------------------------------------------------
 void FRadioMenuItem::processToggle()
 {
-  emitCallback("toggled");
+  static const FSignalId toggled = getSignalId("toggled");
+  emitCallback(toggled);
 }
 
 //----------------------------------------------------------------------
@@ -89,7 +90,8 @@ void FRadioMenuItem::processClicked()
     processToggle();
   }
 
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 }  // namespace finalcut
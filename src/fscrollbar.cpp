@@ -806,7 +806,8 @@ void FScrollbar::avoidScrollOvershoot()
 //----------------------------------------------------------------------
 void FScrollbar::processScroll()
 {
-  emitCallback("change-value");
+  static const FSignalId change_value = getSignalId("change-value");
+  emitCallback(change_value);
   avoidScrollOvershoot();
 }
 
@@ -381,7 +381,8 @@ inline void FSpinBox::decreaseValue()
 //----------------------------------------------------------------------
 void FSpinBox::processChanged()
 {
-  emitCallback("changed");
+  static const FSignalId changed = getSignalId("changed");
+  emitCallback(changed);
 }
 
 //----------------------------------------------------------------------
@@ -115,7 +115,8 @@ void FStatusKey::init (FWidget* parent)
 //----------------------------------------------------------------------
 void FStatusKey::processActivate()
 {
-  emitCallback("activate");
+  static const FSignalId activate = getSignalId("activate");
+  emitCallback(activate);
 }
 
 
@@ -20,6 +20,8 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
+#include <cerrno>
+
 #include "final/fsystem.h"
 
 namespace finalcut
@@ -38,5 +40,45 @@ FSystem::FSystem()
 FSystem::~FSystem()  // destructor
 { }
 
+
+// public methods of FSystem
+//----------------------------------------------------------------------
+std::size_t FSystem::writeAll ( int fd, const char* buffer
+                              , std::size_t length )
+{
+  // Writes the whole buffer and returns the number of written bytes.
+  // On a non-blocking file descriptor, it waits with poll() until
+  // the output can take data again.
+
+  std::size_t written{0};
+
+  while ( written < length )
+  {
+    const ssize_t bytes = write (fd, buffer + written, length - written);
+
+    if ( bytes < 0 )
+    {
+      if ( errno == EINTR )
+        continue;
+
+      if ( errno == EAGAIN || errno == EWOULDBLOCK )
+      {
+        struct pollfd out_fd{};
+        out_fd.fd = fd;
+        out_fd.events = POLLOUT;
+
+        if ( poll(&out_fd, 1, -1) >= 0 || errno == EINTR )
+          continue;
+      }
+
+      break;  // Write error
+    }
+
+    written += std::size_t(bytes);
+  }
+
+  return written;
+}
+
 }  // namespace finalcut
 
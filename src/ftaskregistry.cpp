@@ -0,0 +1,135 @@
+/***********************************************************************
+* ftaskregistry.cpp - Background tasks with a receiver                 *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include "final/ftaskregistry.h"
+
+namespace finalcut
+{
+
+// static class attributes
+std::mutex                 FTaskRegistry::mutex{};
+FTaskRegistry::receiverMap FTaskRegistry::receivers{};
+
+
+//----------------------------------------------------------------------
+// class FTaskRegistry
+//----------------------------------------------------------------------
+
+// public methods of FTaskRegistry
+//----------------------------------------------------------------------
+std::size_t FTaskRegistry::getTaskCount (const FObject* receiver)
+{
+  // Returns the number of tasks with a pending continuation
+
+  std::lock_guard<std::mutex> lock(mutex);
+  return receivers.count(receiver);
+}
+
+//----------------------------------------------------------------------
+bool FTaskRegistry::submit ( FWorkerPool& pool
+                           , const FObject* receiver
+                           , const FTask& task
+                           , const FTask& done
+                           , const FPostFunction& post )
+{
+  // Runs the task in the worker pool and then passes the continuation
+  // done with its receiver to the post function. This does not happen
+  // if the receiver's tasks are cancelled before.
+
+  const auto cancelled = std::make_shared<bool>(false);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    receivers.emplace(receiver, cancelled);
+  }
+
+  auto background_task = [receiver, task, done, post, cancelled] ()
+  {
+    task();
+
+    // The continuation is posted under the lock, so that
+    // cancel() either finds it posted or prevents the posting
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( *cancelled )
+      return;
+
+    remove (receiver, cancelled);
+    post (receiver, done);
+  };
+
+  if ( pool.submit(background_task) )
+    return true;
+
+  // The worker pool is stopped
+  std::lock_guard<std::mutex> lock(mutex);
+  *cancelled = true;
+  remove (receiver, cancelled);
+  return false;
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistry::cancel (const FObject* receiver)
+{
+  // Drops the continuations of the receiver's tasks
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto range = receivers.equal_range(receiver);
+
+  for (auto iter = range.first; iter != range.second; ++iter)
+    *iter->second = true;
+
+  receivers.erase (range.first, range.second);
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistry::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  for (auto&& entry : receivers)
+    *entry.second = true;
+
+  receivers.clear();
+}
+
+
+// private methods of FTaskRegistry
+//----------------------------------------------------------------------
+void FTaskRegistry::remove ( const FObject* receiver
+                           , const std::shared_ptr<bool>& task )
+{
+  // Removes one task of the receiver (the caller holds the lock)
+
+  auto range = receivers.equal_range(receiver);
+
+  for (auto iter = range.first; iter != range.second; ++iter)
+  {
+    if ( iter->second == task )
+    {
+      receivers.erase(iter);
+      return;
+    }
+  }
+}
+
+}  // namespace finalcut
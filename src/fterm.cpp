@@ -21,6 +21,7 @@
 ***********************************************************************/
 
 #include <algorithm>
+#include <cerrno>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 #include "final/fmouse.h"
 #include "final/foptiattr.h"
 #include "final/foptimove.h"
+#include "final/foutputwriter.h"
 #include "final/fstartoptions.h"
 #include "final/fstring.h"
 #include "final/fsystemimpl.h"
@@ -76,6 +78,8 @@ FTermDetection* FTerm::term_detection{nullptr};
 FTermXTerminal* FTerm::xterm         {nullptr};
 FKeyboard*      FTerm::keyboard      {nullptr};
 FMouseControl*  FTerm::mouse         {nullptr};
+FOutputWriter*  FTerm::output_writer {nullptr};
+int             FTerm::signal_pipe[2]{-1, -1};
 
 #if defined(UNIT_TEST)
   FTermLinux*   FTerm::linux         {nullptr};
@@ -155,6 +159,14 @@ int FTerm::getTTYFileDescriptor()
   return ( data ) ? data->getTTYFileDescriptor() : 0;
 }
 
+//----------------------------------------------------------------------
+int FTerm::getSignalPipe()
+{
+  // Returns the read end of the pipe that becomes
+  // readable when a window resize signal has arrived
+  return signal_pipe[0];
+}
+
 //----------------------------------------------------------------------
 char* FTerm::getTermType()
 {
@@ -1141,15 +1153,10 @@ wchar_t FTerm::charEncode (wchar_t c)
 wchar_t FTerm::charEncode (wchar_t c, fc::encoding enc)
 {
   wchar_t ch_enc = c;
+  int index = getCharacterIndex(c);  // Table lookup in O(1)
 
-  for (std::size_t i{0}; i <= fc::lastCharItem; i++)
-  {
-    if ( fc::character[i][fc::UTF8] == uInt(c) )
-    {
-      ch_enc = wchar_t(fc::character[i][enc]);
-      break;
-    }
-  }
+  if ( index != -1 )
+    ch_enc = wchar_t(fc::character[index][enc]);
 
   if ( enc == fc::PC && ch_enc == c )
     ch_enc = finalcut::unicode_to_cp437(c);
@@ -1196,6 +1203,7 @@ void FTerm::putstring (const char str[], int affcnt)
   if ( ! fsys )
     getFSystem();
 
+  waitForOutputWriter();
   fsys->tputs (str, affcnt, FTerm::putchar_ASCII);
 }
 
@@ -1284,6 +1292,20 @@ void FTerm::changeTermSizeFinished()
   data->setTermResized(false);
 }
 
+//----------------------------------------------------------------------
+void FTerm::clearSignalPipe()
+{
+  // Removes the wake-up bytes of the signal handler
+
+  char buf[64];
+
+  if ( signal_pipe[0] == -1 )
+    return;
+
+  while ( read(signal_pipe[0], buf, sizeof(buf)) > 0 )
+    continue;
+}
+
 //----------------------------------------------------------------------
 void FTerm::exitWithMessage (const FString& message)
 {
@@ -2268,6 +2290,10 @@ void FTerm::init (bool disable_alt_screen)
   if ( isXTerminal() )
     xterm->metaSendsESC(true);
 
+  // Pasted text is enclosed in escape sequences
+  if ( isXTerminal() )
+    xterm->setBracketedPaste(true);
+
   // switch to application escape key mode
   enableApplicationEscKey();
 
@@ -2430,6 +2456,10 @@ void FTerm::finish()
   if ( isXTerminal() )
     xterm->metaSendsESC(false);
 
+  // Deactivate the bracketed paste mode
+  if ( isXTerminal() )
+    xterm->setBracketedPaste(false);
+
   // Switch to the normal screen
   useNormalScreenBuffer();
 
@@ -2468,6 +2498,7 @@ void FTerm::finish_encoding()
 //----------------------------------------------------------------------
 void FTerm::setSignalHandler()
 {
+  createSignalPipe();
   signal(SIGTERM,  FTerm::signal_handler);  // Termination signal
   signal(SIGQUIT,  FTerm::signal_handler);  // Quit from keyboard (Ctrl-\)
   signal(SIGINT,   FTerm::signal_handler);  // Keyboard interrupt (Ctrl-C)
@@ -2487,6 +2518,35 @@ void FTerm::resetSignalHandler()
   signal(SIGINT,   SIG_DFL);  // Keyboard interrupt (Ctrl-C)
   signal(SIGQUIT,  SIG_DFL);  // Quit from keyboard (Ctrl-\)
   signal(SIGTERM,  SIG_DFL);  // Termination signal
+  closeSignalPipe();
+}
+
+//----------------------------------------------------------------------
+void FTerm::createSignalPipe()
+{
+  // The signal handler writes into this pipe (self-pipe trick)
+  // to interrupt the waiting for input in the event loop
+
+  if ( signal_pipe[0] != -1 || pipe(signal_pipe) == -1 )
+    return;
+
+  for (int fd : signal_pipe)
+  {
+    fcntl (fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl (fd, F_SETFD, FD_CLOEXEC);
+  }
+}
+
+//----------------------------------------------------------------------
+void FTerm::closeSignalPipe()
+{
+  for (int& fd : signal_pipe)
+  {
+    if ( fd != -1 )
+      close (fd);
+
+    fd = -1;
+  }
 }
 
 //----------------------------------------------------------------------
@@ -2503,6 +2563,16 @@ void FTerm::signal_handler (int signum)
 
       // initialize a resize event to the root element
       data->setTermResized(true);
+
+      if ( signal_pipe[1] != -1 )
+      {
+        // Wakes up the event loop
+        int saved_errno = errno;
+        ssize_t ret = write (signal_pipe[1], "", 1);
+        (void)ret;
+        errno = saved_errno;
+      }
+
       break;
 
     case SIGTERM:
@@ -2521,4 +2591,14 @@ void FTerm::signal_handler (int signum)
   }
 }
 
+//----------------------------------------------------------------------
+void FTerm::waitForOutputWriter()
+{
+  // Output written directly to stdout must not overtake or interleave
+  // with the frames of the output writer thread
+
+  if ( output_writer )
+    output_writer->waitForCompletion();
+}
+
 }  // namespace finalcut
@@ -20,11 +20,11 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
-#if defined(__CYGWIN__)
-  #include "final/fconfig.h"  // includes _GNU_SOURCE for wcwidth()
-#endif
-
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <vector>
 
 #include "final/fcharmap.h"
 #include "final/fterm.h"
@@ -34,8 +34,107 @@
 namespace finalcut
 {
 
-// Function prototypes
-bool hasAmbiguousWidth (wchar_t);
+//----------------------------------------------------------------------
+// class FCharIndexTable
+//----------------------------------------------------------------------
+
+// Two-level lookup table for characters of the basic multilingual plane.
+// The high byte of a character selects a block of 256 entries,
+// the low byte selects the entry within this block.
+
+class FCharIndexTable
+{
+  public:
+    // Constants
+    static constexpr sInt16 NOT_FOUND = -1;
+
+    // Constructor
+    FCharIndexTable();
+
+    // Methods
+    void   insert (wchar_t, sInt16);
+    sInt16 find (wchar_t) const;
+
+  private:
+    // Typedef
+    typedef std::array<sInt16, 256> IndexBlock;
+
+    // Data members
+    std::array<uInt8, 256>  block_number{};  // 0 = empty block
+    std::vector<IndexBlock> blocks{};
+};
+
+// static class attribute
+constexpr sInt16 FCharIndexTable::NOT_FOUND;
+
+// constructor
+//----------------------------------------------------------------------
+FCharIndexTable::FCharIndexTable()
+{
+  IndexBlock empty_block;
+  empty_block.fill(NOT_FOUND);
+  blocks.push_back(empty_block);
+}
+
+// public methods of FCharIndexTable
+//----------------------------------------------------------------------
+void FCharIndexTable::insert (wchar_t ucs, sInt16 index)
+{
+  if ( uInt(ucs) > 0xffff )  // Outside the basic multilingual plane
+    return;
+
+  uInt high = uInt(ucs) >> 8;
+  uInt low = uInt(ucs) & 0xff;
+
+  if ( block_number[high] == 0 )
+  {
+    blocks.push_back(blocks[0]);
+    block_number[high] = uInt8(blocks.size() - 1);
+  }
+
+  auto& entry = blocks[block_number[high]][low];
+
+  if ( entry == NOT_FOUND )  // The first table entry has priority
+    entry = index;
+}
+
+//----------------------------------------------------------------------
+inline sInt16 FCharIndexTable::find (wchar_t ucs) const
+{
+  if ( uInt(ucs) > 0xffff )
+    return NOT_FOUND;
+
+  return blocks[block_number[uInt(ucs) >> 8]][uInt(ucs) & 0xff];
+}
+
+//----------------------------------------------------------------------
+static FCharIndexTable createCharacterIndexTable()
+{
+  // Unicode character -> line number in fc::character
+  // (only the encoded columns of fc::character are changed at runtime)
+
+  FCharIndexTable table{};
+
+  for (std::size_t i{0}; i <= fc::lastCharItem; i++)
+    table.insert (wchar_t(fc::character[i][fc::UTF8]), sInt16(i));
+
+  return table;
+}
+
+//----------------------------------------------------------------------
+static FCharIndexTable createCP437IndexTable()
+{
+  // Unicode character -> CP437 character
+
+  constexpr std::size_t CP437 = 0;
+  constexpr std::size_t UNICODE = 1;
+  FCharIndexTable table{};
+
+  for (std::size_t i{0}; i <= fc::lastCP437Item; i++)
+    table.insert (fc::cp437_ucs[i][UNICODE], sInt16(fc::cp437_ucs[i][CP437]));
+
+  return table;
+}
 
 // Data array
 const wchar_t ambiguous_width_list[] =
@@ -175,6 +274,124 @@ const wchar_t reverse_newfont_list[] =
 };
 
 
+//----------------------------------------------------------------------
+// class FCharWidthTable
+//----------------------------------------------------------------------
+
+// Two-stage column width table for all Unicode code points.
+// Bits 8-20 of a character select a block of 256 widths,
+// which are stored with 2 bits per character. Identical blocks
+// are shared, so the whole table needs less than 12 KiB.
+
+class FCharWidthTable
+{
+  public:
+    // Constructor
+    FCharWidthTable();
+
+    // Method
+    uInt find (wchar_t) const;
+
+  private:
+    // Constants
+    static constexpr uInt MAX_CODE_POINT = 0x10ffff;
+
+    // Typedefs
+    typedef std::array<uInt8, 256> WidthArray;
+    typedef std::array<uInt8, 64> WidthBlock;  // 4 widths per byte
+
+    // Method
+    static void setWidth ( WidthArray&, uInt
+                         , const wchar_t[][2], std::size_t
+                         , std::size_t&, uInt8 );
+
+    // Data members
+    std::array<uInt8, (MAX_CODE_POINT >> 8) + 1> block_number{};
+    std::vector<WidthBlock> blocks{};  // At most 256 distinct blocks
+};
+
+// static class attribute
+constexpr uInt FCharWidthTable::MAX_CODE_POINT;
+
+// constructor
+//----------------------------------------------------------------------
+FCharWidthTable::FCharWidthTable()
+{
+  std::size_t zero_width_index{0};
+  std::size_t double_width_index{0};
+
+  for (uInt high{0}; high < block_number.size(); high++)
+  {
+    const uInt first = high << 8;
+    WidthArray widths;
+    WidthBlock block{};
+    widths.fill(1);
+    setWidth ( widths, first, fc::zeroWidth_range
+             , fc::lastZeroWidthItem, zero_width_index, 0 );
+    setWidth ( widths, first, fc::doubleWidth_range
+             , fc::lastDoubleWidthItem, double_width_index, 2 );
+
+#if defined(__NetBSD__) || defined(__OpenBSD__) \
+ || defined(__FreeBSD__) || defined(__DragonFly__) \
+ || defined(__sun) && defined(__SVR4)
+    for (auto&& wchar : ambiguous_width_list)
+      if ( uInt(wchar) >> 8 == high )
+        widths[uInt(wchar) & 0xff] = 1;
+#endif
+
+    for (std::size_t low{0}; low < widths.size(); low++)
+      block[low >> 2] |= uInt8(widths[low] << ((low & 3) << 1));
+
+    const auto iter = std::find(blocks.begin(), blocks.end(), block);
+    const auto number = std::size_t(iter - blocks.begin());
+
+    // The block number must fit into a uInt8
+    // (Unicode 14.0 needs 103 distinct blocks)
+    assert ( number <= std::numeric_limits<uInt8>::max() );
+    block_number[high] = uInt8(number);
+
+    if ( iter == blocks.end() )
+      blocks.push_back(block);
+  }
+}
+
+// public method of FCharWidthTable
+//----------------------------------------------------------------------
+inline uInt FCharWidthTable::find (wchar_t ucs) const
+{
+  if ( uInt(ucs) > MAX_CODE_POINT )
+    return 0;
+
+  const uInt low = uInt(ucs) & 0xff;
+  const auto& block = blocks[block_number[uInt(ucs) >> 8]];
+  return uInt(block[low >> 2] >> ((low & 3) << 1)) & 0x03;
+}
+
+// private method of FCharWidthTable
+//----------------------------------------------------------------------
+void FCharWidthTable::setWidth ( WidthArray& widths, uInt first
+                               , const wchar_t range[][2], std::size_t last
+                               , std::size_t& index, uInt8 width )
+{
+  // Sets the width of all characters in range that lie
+  // in the block starting with the character first
+
+  const uInt block_end = first + uInt(widths.size()) - 1;
+
+  while ( index <= last && uInt(range[index][1]) < first )
+    index++;
+
+  for (std::size_t i{index}; i <= last && uInt(range[i][0]) <= block_end; i++)
+  {
+    const uInt from = std::max(uInt(range[i][0]), first);
+    const uInt to = std::min(uInt(range[i][1]), block_end);
+
+    for (uInt ucs{from}; ucs <= to; ucs++)
+      widths[ucs - first] = width;
+  }
+}
+
+
 // FTerm non-member functions
 //----------------------------------------------------------------------
 uInt env2uint (const char* env)
@@ -195,10 +412,10 @@ uInt env2uint (const char* env)
 }
 
 //----------------------------------------------------------------------
-inline bool hasAmbiguousWidth (wchar_t wchar)
+bool isReverseNewFontchar (wchar_t wchar)
 {
-  const auto& begin = std::begin(ambiguous_width_list);
-  const auto& end = std::end(ambiguous_width_list);
+  const auto& begin = std::begin(reverse_newfont_list);
+  const auto& end = std::end(reverse_newfont_list);
 
   if ( std::find(begin, end, wchar) != end )  // found
     return true;
@@ -207,15 +424,12 @@ inline bool hasAmbiguousWidth (wchar_t wchar)
 }
 
 //----------------------------------------------------------------------
-bool isReverseNewFontchar (wchar_t wchar)
+int getCharacterIndex (wchar_t ucs)
 {
-  const auto& begin = std::begin(reverse_newfont_list);
-  const auto& end = std::end(reverse_newfont_list);
-
-  if ( std::find(begin, end, wchar) != end )  // found
-    return true;
+  // Returns the line number of ucs in fc::character or -1
 
-  return false;
+  static const auto table = createCharacterIndexTable();
+  return table.find(ucs);
 }
 
 //----------------------------------------------------------------------
@@ -223,6 +437,11 @@ wchar_t cp437_to_unicode (uChar c)
 {
   constexpr std::size_t CP437 = 0;
   constexpr std::size_t UNICODE = 1;
+
+  // The table is sorted by the CP437 character
+  if ( c <= fc::lastCP437Item && fc::cp437_ucs[c][CP437] == c )
+    return fc::cp437_ucs[c][UNICODE];
+
   wchar_t ucs = c;
 
   for (std::size_t i{0}; i <= fc::lastCP437Item; i++)
@@ -240,20 +459,13 @@ wchar_t cp437_to_unicode (uChar c)
 //----------------------------------------------------------------------
 uChar unicode_to_cp437 (wchar_t ucs)
 {
-  constexpr std::size_t CP437 = 0;
-  constexpr std::size_t UNICODE = 1;
-  uChar c{'?'};
+  static const auto table = createCP437IndexTable();
+  sInt16 c = table.find(ucs);
 
-  for (std::size_t i{0}; i <= fc::lastCP437Item; i++)
-  {
-    if ( fc::cp437_ucs[i][UNICODE] == ucs )  // found
-    {
-      c = uChar(fc::cp437_ucs[i][CP437]);
-      break;
-    }
-  }
+  if ( c == FCharIndexTable::NOT_FOUND )
+    return '?';
 
-  return c;
+  return uChar(c);
 }
 
 //----------------------------------------------------------------------
@@ -383,57 +595,74 @@ std::size_t getLengthFromColumnWidth ( const FString& str
   return length;
 }
 
+//----------------------------------------------------------------------
+static std::size_t getColumnWidth (const wchar_t str[], std::size_t length)
+{
+  // The printable ASCII characters (0x20...0x7e) are checked in
+  // groups of eight characters. A group of narrow characters
+  // adds 8 columns without any table lookup.
+
+  constexpr std::size_t group_size = 8;
+  std::size_t column_width{0};
+  std::size_t i{0};
+
+  while ( i + group_size <= length )
+  {
+    uInt non_ascii{0};
+
+    for (std::size_t n{0}; n < group_size; n++)
+      non_ascii |= uInt(uInt(str[i + n]) - 0x20 > 0x5e);
+
+    if ( non_ascii == 0 )
+      column_width += group_size;
+    else
+      for (std::size_t n{0}; n < group_size; n++)
+        column_width += getColumnWidth(str[i + n]);
+
+    i += group_size;
+  }
+
+  for (; i < length; i++)
+    column_width += getColumnWidth(str[i]);
+
+  return column_width;
+}
+
 //----------------------------------------------------------------------
 std::size_t getColumnWidth (const FString& s, std::size_t pos)
 {
   if ( s.isEmpty() )
     return 0;
 
-  std::size_t column_width{0};
   auto length = s.getLength();
 
   if ( pos > length )
     pos = length;
 
-  for (std::size_t i{0}; i < pos; i++)
-    column_width += getColumnWidth(s[i]);
-
-  return column_width;
+  return getColumnWidth (s.wc_str(), pos);
 }
 
 //----------------------------------------------------------------------
 std::size_t getColumnWidth (const FString& s)
 {
-  int column_width{0};
-
   if ( s.isEmpty() )
     return 0;
 
-  for (const auto& wchar : s)
-    column_width += getColumnWidth(wchar);
-
-  return ( column_width == -1 ) ? 0 : std::size_t(column_width);
+  return getColumnWidth (s.wc_str(), s.getLength());
 }
 
 //----------------------------------------------------------------------
 std::size_t getColumnWidth (const wchar_t wchar)
 {
-  int column_width{};
-
-#if defined(__NetBSD__) || defined(__OpenBSD__) \
- || defined(__FreeBSD__) || defined(__DragonFly__) \
- || defined(__sun) && defined(__SVR4)
-  if ( hasAmbiguousWidth(wchar) )
-    column_width = 1;
-  else
-#endif
+  // The column width is taken from a table generated from the Unicode
+  // character database and does not depend on the current locale.
+  // Control characters and combining characters have a width of 0.
 
-  if ( wchar >= fc::NF_rev_left_arrow2 && wchar <= fc::NF_check_mark )
-    column_width = 1;
-  else
-    column_width = wcwidth(wchar);
+  if ( uInt(wchar) - 0x20 < 0x5f )  // Printable ASCII character
+    return 1;
 
-  return ( column_width == -1 ) ? 0 : std::size_t(column_width);
+  static const FCharWidthTable table{};
+  return table.find(wchar);
 }
 
 //----------------------------------------------------------------------
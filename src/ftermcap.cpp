@@ -413,6 +413,7 @@ FTermcap::tcap_map FTermcap::strings[] =
   { 0, "ks" },  // keypad_xmit            -> enter 'key-board_transmit' mode
   { 0, "ke" },  // keypad_local           -> leave 'key-board_transmit' mode
   { 0, "Km" },  // key_mouse              -> Mouse event has occurred
+  { 0, "cs" },  // change_scroll_region   -> change region to line #1 to line #2 (P)
   { 0, "\0" }
 };
 
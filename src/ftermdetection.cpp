@@ -53,6 +53,7 @@ FSystem*       FTermDetection::fsystem{nullptr};
 char           FTermDetection::termtype[256]{};
 char           FTermDetection::ttytypename[256]{};
 bool           FTermDetection::decscusr_support{};
+bool           FTermDetection::sync_output_support{};
 bool           FTermDetection::terminal_detection{};
 bool           FTermDetection::color256{};
 const FString* FTermDetection::answer_back{nullptr};
@@ -79,6 +80,7 @@ FTermDetection::FTermDetection()
 
   // Preset to false
   decscusr_support = false;
+  sync_output_support = false;
 
   // Gnome terminal id from SecDA
   // Example: vte version 0.40.0 = 0 * 100 + 40 * 100 + 0 = 4000
@@ -355,6 +357,9 @@ void FTermDetection::detectTerminal()
     // Identify the terminal via the secondary device attributes (SEC_DA)
     new_termtype = parseSecDA (new_termtype);
 
+    // Checks the support of synchronized output (DEC mode 2026)
+    parseSynchronizedOutputMode();
+
     // Determines the maximum number of colors
     new_termtype = determineMaxColor(new_termtype);
 
@@ -756,6 +761,82 @@ const FString FTermDetection::getSecDA()
   return sec_da_str;
 }
 
+//----------------------------------------------------------------------
+void FTermDetection::parseSynchronizedOutputMode()
+{
+  sync_output_support = false;
+
+  if ( ! canRequestDECMode() )
+    return;
+
+  // Mode values: 1 = set, 2 = reset, 3 = permanently set,
+  //              0 = not recognized, 4 = permanently reset
+  int mode_value = getDECRQM(2026);
+  sync_output_support = ( mode_value >= 1 && mode_value <= 3 );
+}
+
+//----------------------------------------------------------------------
+bool FTermDetection::canRequestDECMode()
+{
+  // Only terminals that are known to answer the DEC private mode
+  // report request (DECRQM) get asked. Any other terminal would
+  // delay the start by the full timeout, and a late answer would
+  // be read as keyboard input.
+
+  // Consoles do not know DECRQM, and screen or tmux may have
+  // inherited the XTERM_VERSION of the outer terminal
+  if ( isLinuxTerm() || isCygwinTerminal() || isFreeBSDTerm()
+    || isNetBSDTerm() || isOpenBSDTerm() || isSunTerminal()
+    || isScreenTerm() || isTmuxTerm() )
+    return false;
+
+  if ( isMinttyTerm() )
+    return true;
+
+  // VTE >= 0.53.0 (terminal ID 65)
+  if ( isGnomeTerminal() && gnome_terminal_id >= 5300 )
+    return true;
+
+  // A real xterm sets XTERM_VERSION
+  if ( color_env.string3 )
+    return true;
+
+  // Terminals that identify themselves by their own terminal type
+  return std::strncmp(termtype, "xterm-kitty", 11) == 0
+      || std::strncmp(termtype, "foot", 4) == 0
+      || std::strncmp(termtype, "alacritty", 9) == 0
+      || std::strncmp(termtype, "wezterm", 7) == 0
+      || std::strncmp(termtype, "contour", 7) == 0;
+}
+
+//----------------------------------------------------------------------
+int FTermDetection::getDECRQM (int mode)
+{
+  // Request the state of a DEC private mode
+
+  int answer_mode{-1}
+    , mode_value{-1}
+    , stdin_no{FTermios::getStdIn()};
+  fd_set ifds{};
+  struct timeval tv{};
+
+  std::fprintf (stdout, CSI "?%d$p", mode);
+  std::fflush (stdout);
+
+  FD_ZERO(&ifds);
+  FD_SET(stdin_no, &ifds);
+  tv.tv_sec  = 0;
+  tv.tv_usec = 150000;  // 150 ms
+
+  // Read the answer
+  if ( select (stdin_no + 1, &ifds, 0, 0, &tv) > 0
+    && std::scanf("\033[?%10d;%10d$y", &answer_mode, &mode_value) == 2
+    && answer_mode == mode )
+    return mode_value;
+
+  return -1;
+}
+
 //----------------------------------------------------------------------
 char* FTermDetection::secDA_Analysis (char current_termtype[])
 {
@@ -173,6 +173,17 @@ void FTermXTerminal::metaSendsESC (bool enable)
     disableXTermMetaSendsESC();
 }
 
+//----------------------------------------------------------------------
+void FTermXTerminal::setBracketedPaste (bool enable)
+{
+  // activate/deactivate the xterm bracketed paste mode
+
+  if ( enable )
+    enableXTermBracketedPaste();
+  else
+    disableXTermBracketedPaste();
+}
+
 //----------------------------------------------------------------------
 void FTermXTerminal::init()
 {
@@ -830,4 +841,30 @@ void FTermXTerminal::disableXTermMetaSendsESC()
   meta_sends_esc = false;
 }
 
+//----------------------------------------------------------------------
+void FTermXTerminal::enableXTermBracketedPaste()
+{
+  // Activate the xterm bracketed paste mode
+
+  if ( bracketed_paste )
+    return;
+
+  FTerm::putstring (CSI "?2004h");  // enable bracketed paste mode
+  std::fflush(stdout);
+  bracketed_paste = true;
+}
+
+//----------------------------------------------------------------------
+void FTermXTerminal::disableXTermBracketedPaste()
+{
+  // Deactivate the xterm bracketed paste mode
+
+  if ( ! bracketed_paste )
+    return;
+
+  FTerm::putstring (CSI "?2004l");  // disable bracketed paste mode
+  std::fflush(stdout);
+  bracketed_paste = false;
+}
+
 }  // namespace finalcut
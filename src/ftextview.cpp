@@ -725,7 +725,8 @@ inline bool FTextView::isPrintable (wchar_t ch)
 //----------------------------------------------------------------------
 void FTextView::processChanged()
 {
-  emitCallback("changed");
+  static const FSignalId changed = getSignalId("changed");
+  emitCallback(changed);
 }
 
 //----------------------------------------------------------------------
@@ -0,0 +1,282 @@
+/***********************************************************************
+* ftimerheap.cpp - Priority queue of the object timers                 *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "final/fobject.h"
+#include "final/ftimerheap.h"
+
+namespace finalcut
+{
+
+// static class attributes
+constexpr std::size_t FTimerHeap::NOT_QUEUED;
+
+
+//----------------------------------------------------------------------
+// class FTimerHeap
+//----------------------------------------------------------------------
+
+// public methods of FTimerHeap
+//----------------------------------------------------------------------
+const FTimerHeap::FTimerData* FTimerHeap::find (int id) const
+{
+  if ( id <= 0
+    || std::size_t(id) >= position.size()
+    || position[std::size_t(id)] == NOT_QUEUED )
+    return nullptr;
+
+  return &heap[position[std::size_t(id)]];
+}
+
+//----------------------------------------------------------------------
+std::size_t FTimerHeap::count (const FObject* object) const
+{
+  // Returns the number of timers of the given object
+
+  const auto iter = object_timers.find(object);
+
+  if ( iter == object_timers.end() )
+    return 0;
+
+  return iter->second.size();
+}
+
+//----------------------------------------------------------------------
+int FTimerHeap::insert ( FObject* object
+                       , const timeval& interval
+                       , const timeval& timeout
+                       , bool one_shot )
+{
+  // Queues a new timer and returns its identifier number
+
+  const int id = getFreeId();
+
+  if ( id <= 0 )
+    return 0;
+
+  if ( std::size_t(id) >= position.size() )
+    position.resize (std::size_t(id) + 1, NOT_QUEUED);
+
+  FTimerData t{ id, interval, timeout, object, one_shot, sequence++ };
+  heap.push_back(t);
+  position[std::size_t(id)] = heap.size() - 1;
+  siftUp (heap.size() - 1);
+  object_timers[object].push_back(id);
+  return id;
+}
+
+//----------------------------------------------------------------------
+bool FTimerHeap::erase (int id)
+{
+  // Removes a timer by using the timer identifier number
+
+  const FTimerData* timer = find(id);
+
+  if ( ! timer )
+    return false;
+
+  unlinkObject (id, timer->object);
+  removeNode (position[std::size_t(id)]);
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool FTimerHeap::erase (const FObject* object)
+{
+  // Removes all timers of the given object
+
+  const auto iter = object_timers.find(object);
+
+  if ( iter == object_timers.end() )
+    return false;
+
+  const std::vector<int> ids = std::move(iter->second);
+  object_timers.erase(iter);
+
+  for (int id : ids)
+    removeNode (position[std::size_t(id)]);
+
+  return true;
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::clear()
+{
+  heap.clear();
+  heap.shrink_to_fit();
+  position.clear();
+  position.shrink_to_fit();
+  free_ids = FreeIdQueue();
+  object_timers.clear();
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::reschedule (const timeval& timeout)
+{
+  // Sets a new timeout for the next timer in the queue
+
+  if ( heap.empty() )
+    return;
+
+  heap.front().timeout = timeout;
+  heap.front().sequence = sequence++;
+  siftDown (0);
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::pop()
+{
+  // Removes the next timer from the queue
+
+  if ( heap.empty() )
+    return;
+
+  unlinkObject (heap.front().id, heap.front().object);
+  removeNode (0);
+}
+
+
+// private methods of FTimerHeap
+//----------------------------------------------------------------------
+inline bool FTimerHeap::isBefore (std::size_t a, std::size_t b) const
+{
+  const timeval& t1 = heap[a].timeout;
+  const timeval& t2 = heap[b].timeout;
+
+  if ( t1 < t2 )
+    return true;
+
+  if ( t2 < t1 )
+    return false;
+
+  return heap[a].sequence < heap[b].sequence;
+}
+
+//----------------------------------------------------------------------
+inline void FTimerHeap::swapNodes (std::size_t a, std::size_t b)
+{
+  std::swap (heap[a], heap[b]);
+  position[std::size_t(heap[a].id)] = a;
+  position[std::size_t(heap[b].id)] = b;
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::siftUp (std::size_t index)
+{
+  while ( index > 0 )
+  {
+    const std::size_t parent = (index - 1) / 2;
+
+    if ( ! isBefore(index, parent) )
+      break;
+
+    swapNodes (index, parent);
+    index = parent;
+  }
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::siftDown (std::size_t index)
+{
+  const std::size_t n = heap.size();
+
+  while ( true )
+  {
+    const std::size_t left = 2 * index + 1;
+    const std::size_t right = left + 1;
+    std::size_t first = index;
+
+    if ( left < n && isBefore(left, first) )
+      first = left;
+
+    if ( right < n && isBefore(right, first) )
+      first = right;
+
+    if ( first == index )
+      break;
+
+    swapNodes (index, first);
+    index = first;
+  }
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::removeNode (std::size_t index)
+{
+  // Removes the heap node and releases the timer id
+
+  const int id = heap[index].id;
+  const std::size_t last = heap.size() - 1;
+
+  if ( index != last )
+  {
+    swapNodes (index, last);
+    heap.pop_back();
+    siftDown (index);
+    siftUp (index);
+  }
+  else
+    heap.pop_back();
+
+  position[std::size_t(id)] = NOT_QUEUED;
+  free_ids.push(id);
+}
+
+//----------------------------------------------------------------------
+void FTimerHeap::unlinkObject (int id, const FObject* object)
+{
+  auto iter = object_timers.find(object);
+
+  if ( iter == object_timers.end() )
+    return;
+
+  auto& ids = iter->second;
+  ids.erase (std::remove(ids.begin(), ids.end(), id), ids.end());
+
+  if ( ids.empty() )
+    object_timers.erase(iter);
+}
+
+//----------------------------------------------------------------------
+int FTimerHeap::getFreeId()
+{
+  // Reuses the smallest released id first
+
+  if ( ! free_ids.empty() )
+  {
+    const int id = free_ids.top();
+    free_ids.pop();
+    return id;
+  }
+
+  const std::size_t next_id = std::max(position.size(), std::size_t(1));
+
+  if ( next_id > std::size_t(INT_MAX) )
+    return 0;
+
+  return int(next_id);
+}
+
+}  // namespace finalcut
@@ -412,13 +412,15 @@ void FToggleButton::drawLabel()
 //----------------------------------------------------------------------
 void FToggleButton::processClick()
 {
-  emitCallback("clicked");
+  static const FSignalId clicked = getSignalId("clicked");
+  emitCallback(clicked);
 }
 
 //----------------------------------------------------------------------
 void FToggleButton::processToggle()
 {
-  emitCallback("toggled");
+  static const FSignalId toggled = getSignalId("toggled");
+  emitCallback(toggled);
 }
 
 //----------------------------------------------------------------------
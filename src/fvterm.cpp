@@ -20,7 +20,9 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
-#include <queue>
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -31,9 +33,12 @@
 #include "final/fkeyboard.h"
 #include "final/foptiattr.h"
 #include "final/foptimove.h"
+#include "final/foutputwriter.h"
 #include "final/fsystem.h"
 #include "final/fterm.h"
 #include "final/ftermdata.h"
+#include "final/ftermdetection.h"
+#include "final/ftermios.h"
 #include "final/ftermbuffer.h"
 #include "final/ftermcap.h"
 #include "final/ftypes.h"
@@ -47,18 +52,53 @@ namespace finalcut
 // global FVTerm object
 static FVTerm* init_object{nullptr};
 
+namespace
+{
+
+//----------------------------------------------------------------------
+uInt8 getPrintedAttributeMask()
+{
+  // Attribute byte #1 without the character set bits,
+  // which charsetChanges() sets only when the character is printed
+
+  FChar mask{};
+  mask.attr.byte[1] = 0xff;
+  mask.attr.bit.alt_charset = false;
+  mask.attr.bit.pc_charset = false;
+  return mask.attr.byte[1];
+}
+
+const uInt8 printed_attribute_mask = getPrintedAttributeMask();
+
+}  // anonymous namespace
+
 // static class attributes
 bool                 FVTerm::terminal_update_complete{false};
-bool                 FVTerm::terminal_update_pending{false};
 bool                 FVTerm::force_terminal_update{false};
 bool                 FVTerm::stop_terminal_updates{false};
+bool                 FVTerm::scheduled_terminal_update{false};
+bool                 FVTerm::terminal_frame_output{false};
 int                  FVTerm::skipped_terminal_update{};
+bool                 FVTerm::adaptive_output{true};
+bool                 FVTerm::plain_shadows{false};
+FVTerm::output_degradation FVTerm::degradation_level{FVTerm::no_degradation};
+FVTerm::output_degradation FVTerm::requested_degradation{FVTerm::no_degradation};
+uInt64               FVTerm::average_frame_size{0};
+int                  FVTerm::saved_baud_rate{0};
+FLinkSpeedMeter      FVTerm::link_meter{};
+FFrameScheduler      FVTerm::frame_scheduler{};
+timeval              FVTerm::last_congestion{};
 uInt                 FVTerm::erase_char_length{};
 uInt                 FVTerm::repeat_char_length{};
 uInt                 FVTerm::clr_bol_length{};
 uInt                 FVTerm::clr_eol_length{};
 uInt                 FVTerm::cursor_address_length{};
-std::queue<int>*     FVTerm::output_buffer{nullptr};
+std::string*         FVTerm::output_buffer{nullptr};
+FOutputWriter*       FVTerm::output_writer{nullptr};
+uInt64               FVTerm::last_written_bytes{0};
+uInt64               FVTerm::last_write_stall_time{0};
+FVTerm::FCoverageMap* FVTerm::coverage_map{nullptr};
+FVTerm::FTerminalLines* FVTerm::terminal_lines{nullptr};
 FPoint*              FVTerm::term_pos{nullptr};
 FSystem*             FVTerm::fsystem{nullptr};
 FTerm*               FVTerm::fterm{nullptr};
@@ -70,6 +110,8 @@ FChar                FVTerm::term_attribute{};
 FChar                FVTerm::next_attribute{};
 FChar                FVTerm::s_ch{};
 FChar                FVTerm::i_ch{};
+FVTerm::FEncodedChar FVTerm::encoded_char_cache[ENCODED_CHAR_CACHE_SIZE]{};
+fc::encoding         FVTerm::encoded_char_cache_encoding{fc::UNKNOWN};
 
 
 //----------------------------------------------------------------------
@@ -113,6 +155,55 @@ FPoint FVTerm::getPrintCursor()
   return FPoint(0, 0);
 }
 
+//----------------------------------------------------------------------
+void FVTerm::setOutputThread (bool enable)
+{
+  // Writes the terminal output in a separate thread,
+  // so that a slow terminal does not block the event processing
+
+  if ( enable == bool(output_writer) || ! output_buffer )
+    return;
+
+  if ( enable )
+  {
+    flushOutputBuffer();
+
+    try
+    {
+      output_writer = new FOutputWriter;
+    }
+    catch (const std::bad_alloc& ex)
+    {
+      std::cerr << bad_alloc_str << ex.what() << std::endl;
+      return;
+    }
+
+    last_written_bytes = 0;
+    last_write_stall_time = 0;
+    output_writer->start (fsystem, FTermios::getStdOut());
+    FTerm::setOutputWriter (output_writer);
+  }
+  else
+  {
+    FTerm::setOutputWriter (nullptr);
+    output_writer->write (*output_buffer);
+    output_writer->stop();  // Writes the remaining output
+    delete output_writer;
+    output_writer = nullptr;
+  }
+}
+
+//----------------------------------------------------------------------
+void FVTerm::setAdaptiveOutput (bool enable)
+{
+  // Adapts the output to the measured terminal throughput
+
+  adaptive_output = enable;
+
+  if ( ! enable )
+    setOutputDegradation (no_degradation);
+}
+
 //----------------------------------------------------------------------
 void FVTerm::setTermXY (int x, int y)
 {
@@ -144,7 +235,9 @@ void FVTerm::setTermXY (int x, int y)
   if ( move_str )
     appendOutputBuffer(move_str);
 
-  flushOutputBuffer();
+  if ( ! terminal_frame_output )
+    flushOutputBuffer();
+
   term_pos->setPoint(x, y);
 }
 
@@ -158,7 +251,8 @@ void FVTerm::hideCursor (bool enable)
   if ( visibility_str )
     appendOutputBuffer(visibility_str);
 
-  flushOutputBuffer();
+  if ( ! terminal_frame_output )
+    flushOutputBuffer();
 }
 
 //----------------------------------------------------------------------
@@ -206,11 +300,16 @@ void FVTerm::resizeVTerm (const FSize& size)
   const FRect box(0, 0, size.getWidth(), size.getHeight());
   const FSize shadow(0, 0);
   resizeArea (box, shadow, vterm);
+  invalidateTerminalLines();
 }
 
 //----------------------------------------------------------------------
 void FVTerm::putVTerm()
 {
+  // Repaints the whole terminal, including lines that
+  // already match the shadow copy of the terminal
+  invalidateTerminalLines();
+
   for (int i{0}; i < vterm->height; i++)
   {
     vterm->changes[i].xmin = 0;
@@ -252,11 +351,21 @@ void FVTerm::updateTerminal()
     if ( ! terminal_update_complete )
       return;
 
+    // Coalesces the changes into the next scheduled frame
     if ( keyboard->isInputDataPending() )
     {
-      terminal_update_pending = true;
+      frame_scheduler.deferUpdate();
       return;
     }
+
+    if ( ! scheduled_terminal_update )
+    {
+      timeval now{};
+      FObject::getCurrentTime(&now);
+
+      if ( ! frame_scheduler.requestUpdate(now) )
+        return;
+    }
   }
 
   auto data = getFTerm().getFTermData();
@@ -275,17 +384,37 @@ void FVTerm::updateTerminal()
   // Update data on VTerm
   updateVTerm();
 
+  // Changes the output quality outside of the output flush
+  if ( requested_degradation != degradation_level )
+    setOutputDegradation (requested_degradation);
+
   // Checks if VTerm has changes
   if ( ! vterm->has_changes )
     return;
 
+  timeval frame_start{};
+  FObject::getCurrentTime(&frame_start);
+  beginTerminalFrame();
+  adjustTerminalLines();
+
+  // Moves shifted lines with hardware scrolling
+  scrollTerminalLines();
+
   for (uInt y{0}; y < uInt(vterm->height); y++)
     updateTerminalLine (y);
 
+  // The terminal now shows the lines of the virtual terminal
+  if ( canScrollTerminal() )
+    terminal_lines->hash = terminal_lines->vterm_hash;
+
   vterm->has_changes = false;
 
   // sets the new input cursor position
   updateTerminalCursor();
+  endTerminalFrame();
+  timeval frame_end{};
+  FObject::getCurrentTime(&frame_end);
+  frame_scheduler.countFrame (frame_start, frame_end);
 }
 
 //----------------------------------------------------------------------
@@ -616,6 +745,16 @@ FVTerm::FTermArea* FVTerm::getPrintArea()
   return vdesktop;
 }
 
+//----------------------------------------------------------------------
+uInt64 FVTerm::getNextFrameDelay()
+{
+  // Returns the remaining time (in µs) until the next frame is due
+
+  timeval now{};
+  FObject::getCurrentTime(&now);
+  return frame_scheduler.getNextFrameDelay(now);
+}
+
 //----------------------------------------------------------------------
 void FVTerm::createArea ( const FRect& box
                         , const FSize& shadow
@@ -757,16 +896,30 @@ void FVTerm::restoreVTerm (const FRect& box)
   if ( h < 0 )
     return;
 
+  updateCoverageMap();
+
   for (int ty{0}; ty < h; ty++)
   {
     int ypos = y + ty;
+    int xpos = x;
 
-    for (int tx{0}; tx < w; tx++)
+    while ( xpos < x + w )
     {
-      int xpos = x + tx;
       auto tc = &vterm->data[ypos * vterm->width + xpos];  // terminal character
-      auto sc = generateCharacter(FPoint(xpos, ypos));  // shown character
-      std::memcpy (tc, &sc, sizeof(*tc));
+      FChar* span{nullptr};  // shown characters
+      int length = getShownSpan (FPoint(xpos, ypos), x + w - xpos, span);
+
+      if ( length > 0 )
+      {
+        std::memcpy (tc, span, sizeof(*tc) * std::size_t(length));
+        xpos += length;
+      }
+      else
+      {
+        auto sc = generateCharacter(FPoint(xpos, ypos));  // shown character
+        std::memcpy (tc, &sc, sizeof(*tc));
+        xpos++;
+      }
     }
 
     if ( int(vterm->changes[ypos].xmin) > x )
@@ -793,6 +946,7 @@ bool FVTerm::updateVTermCursor (FTermArea* area)
 
   if ( area->input_cursor_visible )
   {
+    updateCoverageMap();
     // area offset
     int ax  = area->offset_left;
     int ay  = area->offset_top;
@@ -932,6 +1086,7 @@ void FVTerm::putArea (FTermArea* area)
 
   // Call the preprocessing handler methods
   callPreprocessingHandler(area);
+  updateCoverageMap();
 
   if ( ax < 0 )
   {
@@ -962,22 +1117,40 @@ void FVTerm::putArea (FTermArea* area)
     if ( ax + line_xmin >= vterm->width )
       continue;
 
-    for (int x = line_xmin; x <= line_xmax; x++)  // Column loop
+    int x = line_xmin;
+
+    while ( x <= line_xmax )  // Column loop
     {
       // Global terminal positions
       int tx = ax + x;
       int ty = ay + y;
 
       if ( tx < 0 || ty < 0 )
+      {
+        x++;
         continue;
+      }
 
       tx -= ol;
+      int length = getOpaqueSpan ( area, FPoint(x, y)
+                                 , FPoint(tx, ty), line_xmax - x + 1 );
+
+      if ( length > 0 )
+      {
+        // Copy the uncovered opaque characters at once
+        putOpaqueSpan (area, FPoint(x, y), FPoint(tx, ty), length);
+        modified = true;
+        x += length;
+        continue;
+      }
 
       if ( updateVTermCharacter(area, FPoint(x, y), FPoint(tx, ty)) )
         modified = true;
 
       if ( ! modified )
         line_xmin++;  // Don't update covered character
+
+      x++;
     }
 
     int _xmin = ax + line_xmin - ol;
@@ -1114,6 +1287,7 @@ void FVTerm::scrollAreaForward (FTermArea* area)
     {
       setTermXY (0, vdesktop->height);
       FTerm::scrollTermForward();
+      invalidateTerminalLines();
       putArea (FPoint(1, 1), vdesktop);
 
       // avoid update lines from 0 to (y_max - 1)
@@ -1172,6 +1346,7 @@ void FVTerm::scrollAreaReverse (FTermArea* area)
     {
       setTermXY (0, 0);
       FTerm::scrollTermReverse();
+      invalidateTerminalLines();
       putArea (FPoint(1, 1), vdesktop);
 
       // avoid update lines from 1 to y_max
@@ -1240,28 +1415,37 @@ void FVTerm::clearArea (FTermArea* area, int fillchar)
 //----------------------------------------------------------------------
 void FVTerm::processTerminalUpdate()
 {
+  // Draws all changes since the last frame in one terminal update.
   // Retains terminal updates if there are unprocessed inputs
+  // or the minimum frame interval has not yet elapsed
   static constexpr int max_skip = 8;
+  timeval now{};
+  FObject::getCurrentTime(&now);
 
-  if ( ! terminal_update_pending )
+  if ( ! frame_scheduler.isUpdateDue(now) )
     return;
 
   if ( ! keyboard->isInputDataPending() )
   {
+    scheduled_terminal_update = true;
     updateTerminal();
-    terminal_update_pending = false;
-    skipped_terminal_update = 0;
+    scheduled_terminal_update = false;
   }
   else if ( skipped_terminal_update > max_skip )
   {
     force_terminal_update = true;
     updateTerminal();
     force_terminal_update = false;
-    terminal_update_pending = false;
-    skipped_terminal_update = 0;
   }
   else
+  {
     skipped_terminal_update++;
+    return;
+  }
+
+  frame_scheduler.clearPendingUpdate();
+  skipped_terminal_update = 0;
+  flushOutputBuffer();
 }
 
 //----------------------------------------------------------------------
@@ -1281,14 +1465,48 @@ void FVTerm::finishTerminalUpdate()
 //----------------------------------------------------------------------
 void FVTerm::flushOutputBuffer()
 {
-  while ( ! output_buffer->empty() )
+  if ( output_writer )
   {
-    static FTerm::defaultPutChar& FTermPutchar = FTerm::putchar();
-    FTermPutchar (output_buffer->front());
-    output_buffer->pop();
+    // Hands over the output to the writer thread
+    const bool has_output = ! output_buffer->empty();
+    output_writer->write (*output_buffer);
+
+    if ( has_output )
+    {
+      // Measures the output written since the last hand over
+      const uInt64 written_bytes = output_writer->getWrittenBytes();
+      const uInt64 stall_time = output_writer->getWriteStallTime();
+      timeval now{};
+      FObject::getCurrentTime(&now);
+      measureLinkSpeed ( std::size_t(written_bytes - last_written_bytes)
+                       , stall_time - last_write_stall_time, now );
+      last_written_bytes = written_bytes;
+      last_write_stall_time = stall_time;
+    }
+
+    return;
   }
 
+  // Output from the stdio stream (e.g. FTerm::putstring) comes first
   std::fflush(stdout);
+
+  if ( output_buffer->empty() )
+    return;
+
+  // Writes the whole output buffer to the terminal with one write()
+  const int stdout_no = FTermios::getStdOut();
+  timeval write_start{};
+  FObject::getCurrentTime(&write_start);
+  const std::size_t written = fsystem->writeAll ( stdout_no
+                                                , output_buffer->data()
+                                                , output_buffer->length() );
+  timeval now{};
+  FObject::getCurrentTime(&now);
+  const timeval diff = now - write_start;
+  const uInt64 write_time = uInt64(diff.tv_sec) * 1000000
+                          + uInt64(diff.tv_usec);
+  measureLinkSpeed (written, write_time, now);
+  output_buffer->clear();
 }
 
 
@@ -1365,62 +1583,260 @@ inline bool FVTerm::reallocateTextArea (FTermArea* area, std::size_t size)
   return true;
 }
 
+//----------------------------------------------------------------------
+void FVTerm::updateCoverageMap()
+{
+  // Rebuilds the coverage map if a window has been moved, resized,
+  // raised, lowered, shown or hidden since the last call
+
+  if ( ! coverage_map || ! vterm )
+    return;
+
+  auto& map = *coverage_map;
+  auto& windows = map.windows;
+  bool changed = bool( map.width != vterm->width
+                    || map.height != vterm->height );
+  std::size_t n{0};
+
+  if ( FWidget::getWindowList() )
+  {
+    for (auto& win_obj : *FWidget::getWindowList())
+    {
+      auto win = win_obj->getVWin();
+
+      if ( ! win || ! win->visible )
+        continue;
+
+      FCoveringWindow covering_win;
+      covering_win.area   = win;
+      covering_win.x      = win->offset_left;
+      covering_win.y      = win->offset_top;
+      covering_win.width  = win->width + win->right_shadow;
+      covering_win.height = win->height + win->bottom_shadow;
+
+      if ( n == windows.size() )
+      {
+        windows.push_back(covering_win);
+        changed = true;
+      }
+      else if ( windows[n] != covering_win )
+      {
+        windows[n] = covering_win;
+        changed = true;
+      }
+
+      n++;
+    }
+  }
+
+  if ( n != windows.size() )
+  {
+    windows.resize(n);
+    changed = true;
+  }
+
+  if ( ! changed )
+    return;
+
+  map.width = vterm->width;
+  map.height = vterm->height;
+  map.owner.assign(std::size_t(map.width * map.height), 0);
+  map.last_area = nullptr;
+  uInt16 number{0};
+
+  for (const auto& win : windows)
+  {
+    number++;
+    int x_start = std::max(win.x, 0);
+    int x_end = std::min(win.x + win.width, map.width);
+    int y_start = std::max(win.y, 0);
+    int y_end = std::min(win.y + win.height, map.height);
+
+    if ( x_start >= x_end )
+      continue;
+
+    for (int y{y_start}; y < y_end; y++)
+    {
+      auto line = map.owner.begin() + y * map.width;
+      std::fill (line + x_start, line + x_end, number);
+    }
+  }
+}
+
+//----------------------------------------------------------------------
+int FVTerm::getCoverageIndex (FTermArea* area)
+{
+  // Returns the position of the area in the window stack of the
+  // coverage map (-1 = virtual desktop, stack size = not found)
+
+  if ( area == vdesktop )
+    return -1;
+
+  auto& map = *coverage_map;
+
+  if ( area == map.last_area )
+    return map.last_index;
+
+  int index{0};
+
+  for (const auto& win : map.windows)
+  {
+    if ( win.area == area )
+      break;
+
+    index++;
+  }
+
+  map.last_area = area;
+  map.last_index = index;
+  return index;
+}
+
 //----------------------------------------------------------------------
 FVTerm::covered_state FVTerm::isCovered ( const FPoint& pos
                                         , FTermArea* area )
 {
   // Determines the covered state for the given position
 
-  if ( ! area )
+  if ( ! area || ! coverage_map )
     return non_covered;
 
+  const auto& map = *coverage_map;
+  const auto& windows = map.windows;
+  int x = pos.getX();
+  int y = pos.getY();
+  int top = int(windows.size()) - 1;
+  bool inside_map( x >= 0 && x < map.width && y >= 0 && y < map.height );
+
+  if ( inside_map )  // Top-most window at this position
+    top = int(map.owner[std::size_t(y * map.width + x)]) - 1;
+
+  int area_index = getCoverageIndex(area);
+
+  if ( top <= area_index )  // No window above the area
+    return non_covered;
+
+  if ( inside_map )
+  {
+    const auto& win = windows[std::size_t(top)];
+    auto tmp = &win.area->data[(y - win.y) * win.width + (x - win.x)];
+
+    if ( ! tmp->attr.bit.transparent && ! tmp->attr.bit.trans_shadow )
+      return fully_covered;
+  }
+
   auto is_covered = non_covered;
 
-  if ( FWidget::getWindowList() && ! FWidget::getWindowList()->empty() )
+  for (int index = area_index + 1; index <= top; index++)
   {
-    bool found( area == vdesktop );
+    const auto& win = windows[std::size_t(index)];
 
-    for (auto& win_obj : *FWidget::getWindowList())
+    if ( ! win.contains(x, y) )
+      continue;
+
+    auto tmp = &win.area->data[(y - win.y) * win.width + (x - win.x)];
+
+    if ( tmp->attr.bit.trans_shadow )
     {
-      auto win = win_obj->getVWin();
+      is_covered = half_covered;
+    }
+    else if ( ! tmp->attr.bit.transparent )
+    {
+      is_covered = fully_covered;
+      break;
+    }
+  }
 
-      if ( ! win )
-        continue;
+  return is_covered;
+}
 
-      if ( ! win->visible )
-        continue;
+//----------------------------------------------------------------------
+inline bool FVTerm::isOpaqueCharacter (const FChar* ch)
+{
+  // An opaque character completely hides the characters below it
 
-      int win_x = win->offset_left;
-      int win_y = win->offset_top;
-      FRect geometry ( win_x
-                     , win_y
-                     , std::size_t(win->width) + std::size_t(win->right_shadow)
-                     , std::size_t(win->height) + std::size_t(win->bottom_shadow) );
+  return ! ch->attr.bit.transparent
+      && ! ch->attr.bit.trans_shadow
+      && ! ch->attr.bit.inherit_bg;
+}
 
-      if ( found && geometry.contains(pos) )
-      {
-        int width = win->width + win->right_shadow;
-        int x = pos.getX();
-        int y = pos.getY();
-        auto tmp = &win->data[(y - win_y) * width + (x - win_x)];
+//----------------------------------------------------------------------
+int FVTerm::getOpaqueSpan ( FTermArea* area
+                          , const FPoint& area_pos
+                          , const FPoint& terminal_pos
+                          , int max_length )
+{
+  // Returns the number of consecutive opaque area characters
+  // from area_pos that are not covered by any other window
 
-        if ( tmp->attr.bit.trans_shadow )
-        {
-          is_covered = half_covered;
-        }
-        else if ( ! tmp->attr.bit.transparent )
-        {
-          is_covered = fully_covered;
-          break;
-        }
-      }
+  const auto& map = *coverage_map;
+  int area_index = getCoverageIndex(area);
+  int width = area->width + area->right_shadow;
+  auto ac = &area->data[area_pos.getY() * width + area_pos.getX()];
+  auto owner = &map.owner[std::size_t( terminal_pos.getY() * map.width
+                                     + terminal_pos.getX() )];
+  int length{0};
 
-      if ( area == win )
-        found = true;
-    }
+  while ( length < max_length
+       && int(owner[length]) - 1 <= area_index
+       && isOpaqueCharacter(&ac[length]) )
+    length++;
+
+  return length;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::putOpaqueSpan ( FTermArea* area
+                           , const FPoint& area_pos
+                           , const FPoint& terminal_pos
+                           , int length )
+{
+  // Copies a run of opaque area characters to the virtual terminal
+  // (same result as updateCharacter() for each character)
+
+  int width = area->width + area->right_shadow;
+  auto ac = &area->data[area_pos.getY() * width + area_pos.getX()];
+  auto tc = &vterm->data[ terminal_pos.getY() * vterm->width
+                        + terminal_pos.getX() ];
+  std::memcpy (tc, ac, sizeof(*tc) * std::size_t(length));
+
+  for (int i{0}; i < length; i++)
+    tc[i].attr.bit.no_changes = tc[i].attr.bit.printed;
+}
+
+//----------------------------------------------------------------------
+int FVTerm::getShownSpan (const FPoint& pos, int max_length, FChar*& span)
+{
+  // Returns the number of consecutive characters from pos that are
+  // shown unchanged from a single area (desktop characters without
+  // a window above them or opaque characters of the top-most window)
+
+  const auto& map = *coverage_map;
+  int x = pos.getX();
+  int y = pos.getY();
+  auto owner = &map.owner[std::size_t(y * map.width + x)];
+  auto number = owner[0];
+  int length{0};
+
+  if ( number == 0 )  // Virtual desktop
+  {
+    span = &vdesktop->data[y * vdesktop->width + x];
+
+    while ( length < max_length && owner[length] == 0 )
+      length++;
+  }
+  else
+  {
+    const auto& win = map.windows[std::size_t(number - 1)];
+    span = &win.area->data[(y - win.y) * win.width + (x - win.x)];
+
+    while ( length < max_length
+         && owner[length] == number
+         && isOpaqueCharacter(&span[length]) )
+      length++;
   }
 
-  return is_covered;
+  return length;
 }
 
 //----------------------------------------------------------------------
@@ -1500,7 +1916,8 @@ void FVTerm::updateShadedCharacter ( FTermArea* area
   oc.attr.bit.reverse  = false;
   oc.attr.bit.standout = false;
 
-  if ( oc.ch == fc::LowerHalfBlock
+  if ( plain_shadows
+    || oc.ch == fc::LowerHalfBlock
     || oc.ch == fc::UpperHalfBlock
     || oc.ch == fc::LeftHalfBlock
     || oc.ch == fc::RightHalfBlock
@@ -1708,33 +2125,32 @@ bool FVTerm::isInsideArea (const FPoint& pos, FTermArea* area)
 FChar FVTerm::generateCharacter (const FPoint& pos)
 {
   // Generates characters for a given position considering all areas
+  // (the coverage map must be up to date)
 
   int x = pos.getX();
   int y = pos.getY();
   auto sc = &vdesktop->data[y * vdesktop->width + x];  // shown character
+  const auto& map = *coverage_map;
+  int top = int(map.owner[std::size_t(y * map.width + x)]) - 1;
 
-  if ( ! FWidget::getWindowList() || FWidget::getWindowList()->empty() )
+  if ( top < 0 )  // No window at this position
     return *sc;
 
-  for (auto& win_obj : *FWidget::getWindowList())
-  {
-    auto win = win_obj->getVWin();
+  const auto& top_win = map.windows[std::size_t(top)];
+  auto top_ch = &top_win.area->data[(y - top_win.y) * top_win.width
+                                    + (x - top_win.x)];
 
-    if ( ! win || ! win->visible )
-      continue;
+  if ( isOpaqueCharacter(top_ch) )
+    return *top_ch;  // The top-most character hides all others
 
-    int win_x = win->offset_left;
-    int win_y = win->offset_top;
-    FRect geometry ( win_x
-                   , win_y
-                   , std::size_t(win->width) + std::size_t(win->right_shadow)
-                   , std::size_t(win->height) + std::size_t(win->bottom_shadow) );
+  for (int index{0}; index <= top; index++)
+  {
+    const auto& win = map.windows[std::size_t(index)];
 
     // Window is visible and contains current character
-    if ( geometry.contains(x, y) )
+    if ( win.contains(x, y) )
     {
-      int line_len = win->width + win->right_shadow;
-      auto tmp = &win->data[(y - win_y) * line_len + (x - win_x)];
+      auto tmp = &win.area->data[(y - win.y) * win.width + (x - win.x)];
 
       if ( ! tmp->attr.bit.transparent )   // Current character not transparent
       {
@@ -1749,7 +2165,8 @@ FChar FVTerm::generateCharacter (const FPoint& pos)
           s_ch.attr.bit.reverse  = false;
           s_ch.attr.bit.standout = false;
 
-          if ( s_ch.ch == fc::LowerHalfBlock
+          if ( plain_shadows
+            || s_ch.ch == fc::LowerHalfBlock
             || s_ch.ch == fc::UpperHalfBlock
             || s_ch.ch == fc::LeftHalfBlock
             || s_ch.ch == fc::RightHalfBlock
@@ -1863,12 +2280,15 @@ void FVTerm::init (bool disable_alt_screen)
   vterm       = nullptr;
   vdesktop    = nullptr;
   fsystem     = FTerm::getFSystem();
+  link_meter.setOutput (fsystem, FTermios::getStdOut());
 
   try
   {
     fterm         = new FTerm (disable_alt_screen);
     term_pos      = new FPoint(-1, -1);
-    output_buffer = new std::queue<int>;
+    output_buffer = new std::string;
+    coverage_map  = new FCoverageMap;
+    terminal_lines = new FTerminalLines;
   }
   catch (const std::bad_alloc& ex)
   {
@@ -1876,6 +2296,9 @@ void FVTerm::init (bool disable_alt_screen)
     std::abort();
   }
 
+  // Reserve memory for one complete terminal output
+  output_buffer->reserve(TERMINAL_OUTPUT_BUFFER_SIZE);
+
   // term_attribute stores the current state of the terminal
   term_attribute.ch           = '\0';
   term_attribute.fg_color     = fc::Default;
@@ -1942,9 +2365,18 @@ void FVTerm::finish()
 
   flushOutputBuffer();
 
+  // Terminates the writer thread after all output is written
+  unsetOutputThread();
+
   if ( output_buffer )
     delete output_buffer;
 
+  if ( coverage_map )
+    delete coverage_map;
+
+  if ( terminal_lines )
+    delete terminal_lines;
+
   // remove virtual terminal + virtual desktop area
   removeArea (vdesktop);
   removeArea (vterm);
@@ -1986,7 +2418,8 @@ void FVTerm::putAreaCharacter ( const FPoint& pos, FVTerm* obj
       ch.attr.bit.reverse  = false;
       ch.attr.bit.standout = false;
 
-      if ( ch.ch == fc::LowerHalfBlock
+      if ( plain_shadows
+        || ch.ch == fc::LowerHalfBlock
         || ch.ch == fc::UpperHalfBlock
         || ch.ch == fc::LeftHalfBlock
         || ch.ch == fc::RightHalfBlock
@@ -2032,6 +2465,10 @@ void FVTerm::getAreaCharacter ( const FPoint& pos, FTermArea* area
       s_ch.bg_color = tmp->bg_color;
       s_ch.attr.bit.reverse  = false;
       s_ch.attr.bit.standout = false;
+
+      if ( plain_shadows )
+        s_ch.ch = ' ';
+
       cc = &s_ch;
     }
     else if ( tmp->attr.bit.inherit_bg )
@@ -2089,6 +2526,7 @@ bool FVTerm::clearTerm (int fillchar)
     setTermXY (0, 0);
   }
 
+  invalidateTerminalLines();
   flushOutputBuffer();
   return true;
 }
@@ -2732,6 +3170,10 @@ void FVTerm::updateTerminalLine (uInt y)
   uInt& xmin = vt->changes[y].xmin;
   uInt& xmax = vt->changes[y].xmax;
 
+  // Skip characters that are already shown on the terminal
+  if ( xmin <= xmax )
+    reduceLineChanges(y);
+
   if ( xmin <= xmax )  // Line has changes
   {
     bool draw_leading_ws = false;
@@ -2784,11 +3226,378 @@ void FVTerm::updateTerminalLine (uInt y)
     // Reset line changes
     xmin = uInt(vt->width);
     xmax = 0;
+    saveTerminalLine(y);
   }
 
   cursorWrap();
 }
 
+//----------------------------------------------------------------------
+uInt64 FVTerm::getLineHash (int y)
+{
+  // Returns a FNV-1a hash value of the visible content
+  // of line y in the virtual terminal (never 0)
+
+  constexpr uInt64 fnv_prime = 0x100000001b3ULL;
+  uInt64 hash{0xcbf29ce484222325ULL};
+  auto ch = &vterm->data[y * vterm->width];
+
+  for (int x{0}; x < vterm->width; x++, ch++)
+  {
+    uInt64 colored_char = uInt64(uInt32(ch->ch))
+                        | uInt64(ch->fg_color) << 32
+                        | uInt64(ch->bg_color) << 48;
+    uInt64 attributes = uInt64(ch->attr.byte[0])
+                      | uInt64(ch->attr.byte[1] & printed_attribute_mask) << 8
+                      | uInt64(ch->attr.bit.fullwidth_padding) << 16;
+    hash = (hash ^ colored_char) * fnv_prime;
+    hash = (hash ^ attributes) * fnv_prime;
+  }
+
+  return ( hash == 0 ) ? 1 : hash;
+}
+
+//----------------------------------------------------------------------
+inline bool FVTerm::isSameCharacter (const FChar& ch1, const FChar& ch2)
+{
+  // Compares the visible content of two characters without branches
+
+  return ( uInt(ch1.ch ^ ch2.ch)
+         | uInt(ch1.fg_color ^ ch2.fg_color)
+         | uInt(ch1.bg_color ^ ch2.bg_color)
+         | uInt(ch1.attr.byte[0] ^ ch2.attr.byte[0])
+         | uInt((ch1.attr.byte[1] ^ ch2.attr.byte[1]) & printed_attribute_mask)
+         | uInt(ch1.attr.bit.fullwidth_padding
+              ^ ch2.attr.bit.fullwidth_padding) ) == 0;
+}
+
+//----------------------------------------------------------------------
+uInt FVTerm::findFirstDifference ( const FChar line1[], const FChar line2[]
+                                 , uInt from, uInt to )
+{
+  // Returns the position of the first different character
+  // in [from .. to] or to + 1 if all characters are the same
+
+  uInt x = from;
+
+  while ( x <= to && isSameCharacter(line1[x], line2[x]) )
+    x++;
+
+  return x;
+}
+
+//----------------------------------------------------------------------
+uInt FVTerm::findLastDifference ( const FChar line1[], const FChar line2[]
+                                , uInt from, uInt to )
+{
+  // Returns the position of the last different character in
+  // [from .. to] (the character at position from must differ)
+
+  uInt x = to;
+
+  while ( x > from && isSameCharacter(line1[x], line2[x]) )
+    x--;
+
+  return x;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::reduceLineChanges (uInt y)
+{
+  // Reduces the change range of line y to the characters
+  // that differ from the characters shown on the terminal
+
+  auto& term_lines = *terminal_lines;
+
+  if ( ! term_lines.known[y] )
+    return;
+
+  uInt& xmin = vterm->changes[y].xmin;
+  uInt& xmax = vterm->changes[y].xmax;
+  const auto width = uInt(vterm->width);
+  const auto vt_line = &vterm->data[y * width];
+  const auto shown_line = &term_lines.shadow[y * width];
+  markAsPrinted (xmin, xmax, y);
+  uInt first = findFirstDifference (vt_line, shown_line, xmin, xmax);
+
+  if ( first > xmax )  // No differences
+  {
+    xmin = width;
+    xmax = 0;
+    return;
+  }
+
+  uInt last = findLastDifference (vt_line, shown_line, first, xmax);
+
+  // Never split a full-width character
+  if ( first > 0
+    && ( vt_line[first].attr.bit.fullwidth_padding
+      || shown_line[first].attr.bit.fullwidth_padding ) )
+    first--;
+
+  if ( last + 1 < width
+    && ( vt_line[last + 1].attr.bit.fullwidth_padding
+      || shown_line[last + 1].attr.bit.fullwidth_padding ) )
+    last++;
+
+  xmin = first;
+  xmax = last;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::saveTerminalLine (uInt y)
+{
+  // Stores line y of the virtual terminal as shown terminal line
+
+  auto& term_lines = *terminal_lines;
+  const auto width = std::size_t(vterm->width);
+  std::memcpy ( &term_lines.shadow[y * width]
+              , &vterm->data[y * width]
+              , sizeof(FChar) * width );
+  term_lines.known[y] = true;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::adjustTerminalLines()
+{
+  // Adapts the terminal line buffers to the virtual terminal size
+
+  auto& term_lines = *terminal_lines;
+
+  if ( term_lines.width == vterm->width
+    && term_lines.height == vterm->height )
+    return;
+
+  const auto height = std::size_t(vterm->height);
+  term_lines.width = vterm->width;
+  term_lines.height = vterm->height;
+  term_lines.shadow.resize(std::size_t(term_lines.width) * height);
+  term_lines.known.assign(height, false);
+  term_lines.hash.assign(height, 0);
+  term_lines.vterm_hash.assign(height, 0);
+}
+
+//----------------------------------------------------------------------
+void FVTerm::invalidateTerminalLines()
+{
+  // The terminal content is unknown after a direct terminal output
+
+  if ( ! terminal_lines )
+    return;
+
+  auto& term_lines = *terminal_lines;
+  std::fill (term_lines.known.begin(), term_lines.known.end(), false);
+  std::fill (term_lines.hash.begin(), term_lines.hash.end(), 0);
+}
+
+//----------------------------------------------------------------------
+bool FVTerm::canScrollTerminal()
+{
+  return terminal_lines
+      && TCAP(fc::t_change_scroll_region)
+      && TCAP(fc::t_scroll_forward)
+      && TCAP(fc::t_scroll_reverse);
+}
+
+//----------------------------------------------------------------------
+void FVTerm::scrollTerminalLines()
+{
+  // Moves terminal lines that have been shifted vertically in
+  // the virtual terminal with a scroll region, so that only the
+  // exposed lines have to be redrawn
+
+  if ( ! canScrollTerminal() )
+    return;
+
+  auto& term_lines = *terminal_lines;
+  const auto height = std::size_t(vterm->height);
+
+  for (std::size_t y{0}; y < height; y++)
+  {
+    const auto& changes = vterm->changes[y];
+
+    if ( changes.xmin <= changes.xmax || term_lines.hash[y] == 0 )
+      term_lines.vterm_hash[y] = getLineHash(int(y));
+    else
+      term_lines.vterm_hash[y] = term_lines.hash[y];
+  }
+
+  static constexpr int max_regions = 4;
+  int top{}, bottom{}, distance{};
+
+  for (int n{0}; n < max_regions; n++)
+  {
+    if ( ! findScrolledLines(top, bottom, distance) )
+      break;
+
+    scrollTerminalRegion (top, bottom, distance);
+  }
+}
+
+//----------------------------------------------------------------------
+bool FVTerm::findScrolledLines (int& top, int& bottom, int& distance)
+{
+  // Searches for the line range [top .. bottom] whose content was
+  // shown 'distance' lines lower on the terminal and that saves the
+  // most output when it is moved with hardware scrolling
+
+  const auto& term_lines = *terminal_lines;
+  const auto& term_hash = term_lines.hash;
+  const auto& vterm_hash = term_lines.vterm_hash;
+  const int height = vterm->height;
+  const int width = vterm->width;
+  const int csr_length = \
+      int(std::strlen(TCAP(fc::t_change_scroll_region)));
+  const int forward_length = int(std::strlen(TCAP(fc::t_scroll_forward)));
+  const int reverse_length = int(std::strlen(TCAP(fc::t_scroll_reverse)));
+  int best_savings{0};
+
+  // The hash value is only a pre-filter, the line content
+  // must match the shown terminal line character by character
+  auto is_shown_at = [&] (int y, int shown_y)
+  {
+    const auto index = std::size_t(shown_y);
+
+    if ( term_hash[index] == 0
+      || vterm_hash[std::size_t(y)] != term_hash[index]
+      || ! term_lines.known[index] )
+      return false;
+
+    const auto last_x = uInt(width - 1);
+    const auto vt_line = &vterm->data[y * width];
+    const auto shown_line = &term_lines.shadow[index * std::size_t(width)];
+    return findFirstDifference (vt_line, shown_line, 0, last_x) > last_x;
+  };
+
+  auto changed_chars = [&] (int y)
+  {
+    const auto& changes = vterm->changes[y];
+    return ( changes.xmin <= changes.xmax )
+           ? int(changes.xmax - changes.xmin) + 1
+           : 0;
+  };
+
+  for (int d{1 - height}; d < height; d++)
+  {
+    if ( d == 0 )
+      continue;
+
+    const int scroll_length = ( d > 0 ) ? forward_length : reverse_length;
+    const int first = std::max(0, -d);
+    const int last = std::min(height, height - d) - 1;
+    int run_start{-1};
+    int gain{0};
+
+    for (int y{first}; y <= last + 1; y++)
+    {
+      if ( y <= last && is_shown_at(y, y + d) )
+      {
+        if ( run_start < 0 )
+        {
+          run_start = y;
+          gain = 0;
+        }
+
+        if ( vterm_hash[std::size_t(y)] != term_hash[std::size_t(y)] )
+          gain += changed_chars(y);
+
+        continue;
+      }
+
+      if ( run_start < 0 )
+        continue;
+
+      // Costs for the scroll region and the exposed lines
+      int costs = 2 * (csr_length + int(cursor_address_length))
+                + std::abs(d) * scroll_length;
+      int exposed = ( d > 0 ) ? y : run_start + d;
+
+      for (int n{0}; n < std::abs(d); n++)
+        costs += width - changed_chars(exposed + n);
+
+      if ( gain - costs > best_savings )
+      {
+        best_savings = gain - costs;
+        top = run_start;
+        bottom = y - 1;
+        distance = d;
+      }
+
+      run_start = -1;
+    }
+  }
+
+  return best_savings > 0;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::scrollTerminalRegion (int top, int bottom, int distance)
+{
+  // Moves the terminal lines [top + distance .. bottom + distance]
+  // to the lines [top .. bottom]
+
+  auto& term_lines = *terminal_lines;
+  auto& term_hash = term_lines.hash;
+  const auto& csr = TCAP(fc::t_change_scroll_region);
+  const int width = vterm->width;
+  const int first = std::min(top, top + distance);
+  const int last = std::max(bottom, bottom + distance);
+  const int count = std::abs(distance);
+  const auto begin = term_hash.begin();
+  int exposed_first{}, exposed_last{};
+
+  appendOutputBuffer (tparm(csr, first, last, 0, 0, 0, 0, 0, 0, 0));
+  term_pos->setPoint(-1, -1);  // Undefined cursor position
+
+  if ( distance > 0 )  // Scroll up
+  {
+    setTermXY (0, last);
+
+    for (int n{0}; n < count; n++)
+      appendOutputBuffer (TCAP(fc::t_scroll_forward));
+
+    std::copy (begin + first + count, begin + last + 1, begin + first);
+    exposed_first = last - count + 1;
+    exposed_last = last;
+  }
+  else  // Scroll down
+  {
+    setTermXY (0, first);
+
+    for (int n{0}; n < count; n++)
+      appendOutputBuffer (TCAP(fc::t_scroll_reverse));
+
+    std::copy_backward (begin + first, begin + last + 1 - count, begin + last + 1);
+    exposed_first = first;
+    exposed_last = first + count - 1;
+  }
+
+  appendOutputBuffer (tparm(csr, 0, vterm->height - 1, 0, 0, 0, 0, 0, 0, 0));
+  term_pos->setPoint(-1, -1);
+
+  // The moved lines are already up to date
+  for (int y{top}; y <= bottom; y++)
+  {
+    vterm->changes[y].xmin = uInt(width);
+    vterm->changes[y].xmax = 0;
+    markAsPrinted (0, uInt(width - 1), uInt(y));
+    saveTerminalLine (uInt(y));
+  }
+
+  // The exposed lines must be completely redrawn
+  for (int y{exposed_first}; y <= exposed_last; y++)
+  {
+    auto line = &vterm->data[y * width];
+    term_hash[std::size_t(y)] = 0;
+    term_lines.known[std::size_t(y)] = false;
+    vterm->changes[y].xmin = 0;
+    vterm->changes[y].xmax = uInt(width - 1);
+
+    for (int x{0}; x < width; x++)
+      line[x].attr.bit.no_changes = false;
+  }
+}
+
 //----------------------------------------------------------------------
 bool FVTerm::updateTerminalCursor()
 {
@@ -2843,6 +3652,176 @@ inline bool FVTerm::isTermSizeChanged()
   return false;
 }
 
+//----------------------------------------------------------------------
+void FVTerm::beginTerminalFrame()
+{
+  // The output buffer holds the whole frame and is not flushed
+  // before the frame is complete
+  terminal_frame_output = true;
+
+  // The terminal displays the frame only after its completion
+  if ( FTermDetection::hasSynchronizedOutputSupport() )
+    appendOutputBuffer (CSI "?2026h");
+}
+
+//----------------------------------------------------------------------
+void FVTerm::endTerminalFrame()
+{
+  if ( FTermDetection::hasSynchronizedOutputSupport() )
+    appendOutputBuffer (CSI "?2026l");
+
+  // Moving average of the frame size
+  const uInt64 frame_size = output_buffer->length();
+
+  if ( average_frame_size == 0 )
+    average_frame_size = frame_size;
+  else
+    average_frame_size = (7 * average_frame_size + frame_size) / 8;
+
+  updateFrameInterval();
+
+  // Writes the complete frame at once
+  terminal_frame_output = false;
+  flushOutputBuffer();
+}
+
+//----------------------------------------------------------------------
+void FVTerm::updateFrameInterval()
+{
+  // Lowers the frame rate so that the terminal can receive
+  // a frame before the next one
+
+  static constexpr uInt64 max_interval = 500000;  // 2 frames per second
+  const uInt64 link_speed = link_meter.getLinkSpeed();
+  uInt64 interval{0};
+
+  if ( degradation_level >= reduced_frame_rate && link_speed > 0 )
+  {
+    const uInt64 transfer_time = average_frame_size * 1000000 / link_speed;
+    interval = std::min(transfer_time, max_interval);
+  }
+
+  frame_scheduler.setMinFrameInterval (interval);
+}
+
+//----------------------------------------------------------------------
+void FVTerm::measureLinkSpeed ( std::size_t written, uInt64 write_time
+                              , const timeval& now )
+{
+  if ( ! link_meter.measure (written, write_time, now) )
+    return;
+
+  adaptOutputQuality (link_meter.isCongested(), now);
+  updateFrameInterval();
+}
+
+//----------------------------------------------------------------------
+void FVTerm::adaptOutputQuality (bool congested, const timeval& now)
+{
+  // Degrades the output while the terminal cannot keep up
+  // and raises the quality step by step afterwards
+
+  static constexpr uInt64 recovery_time = 2000000;  // 2 seconds
+
+  if ( ! adaptive_output )
+    return;
+
+  // The new level is applied with the next frame
+  if ( congested )
+  {
+    last_congestion = now;
+    requested_degradation = getDegradationLevel(link_meter.getLinkSpeed());
+  }
+  else if ( requested_degradation != no_degradation
+         && FObject::isTimeout (&last_congestion, recovery_time) )
+  {
+    last_congestion = now;
+    requested_degradation = output_degradation(requested_degradation - 1);
+  }
+}
+
+//----------------------------------------------------------------------
+FVTerm::output_degradation FVTerm::getDegradationLevel (uInt64 speed)
+{
+  // Link speeds in bytes per second
+  static constexpr uInt64 slow_link = 16000;        // 128 kbit/s
+  static constexpr uInt64 medium_link = 64000;      // 512 kbit/s
+  static constexpr uInt64 fast_link = 1000000;      //   8 Mbit/s
+
+  if ( speed == 0 || speed >= fast_link )
+    return no_degradation;
+  else if ( speed >= medium_link )
+    return reduced_frame_rate;
+  else if ( speed >= slow_link )
+    return reduced_output;
+  else
+    return minimal_output;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::setOutputDegradation (output_degradation level)
+{
+  if ( level == degradation_level )
+    return;
+
+  const bool was_reduced = bool(degradation_level >= reduced_output);
+  const bool is_reduced = bool(level >= reduced_output);
+  const bool plain = bool(level == minimal_output);
+  auto optimove = FTerm::getFOptiMove();
+  degradation_level = level;
+  requested_degradation = level;
+  updateFrameInterval();
+
+  if ( optimove && is_reduced != was_reduced )
+  {
+    if ( is_reduced )
+    {
+      // 9 bits per character (see FOptiMove::calculateCharDuration)
+      const uInt64 baud = std::min ( link_meter.getLinkSpeed() * 9
+                                   , uInt64(INT_MAX) );
+      saved_baud_rate = optimove->getBaudRate();
+      optimove->setBaudRate (int(baud));
+    }
+    else
+      optimove->setBaudRate (saved_baud_rate);
+
+    init_characterLengths (optimove);
+  }
+
+  if ( plain != plain_shadows )
+  {
+    plain_shadows = plain;
+    restoreShadows();
+  }
+}
+
+//----------------------------------------------------------------------
+void FVTerm::restoreShadows()
+{
+  // Redraws the window shadows in the current shadow style
+
+  if ( ! vterm || ! coverage_map )
+    return;
+
+  updateCoverageMap();
+  const auto& windows = coverage_map->windows;
+
+  for (std::size_t i{0}; i < windows.size(); i++)
+  {
+    const FCoveringWindow win = windows[i];
+    const int rsh = win.area->right_shadow;
+    const int bsh = win.area->bottom_shadow;
+
+    if ( rsh > 0 )
+      restoreVTerm (FRect ( win.x + win.width - rsh + 1, win.y + 1
+                          , std::size_t(rsh), std::size_t(win.height) ));
+
+    if ( bsh > 0 )
+      restoreVTerm (FRect ( win.x + 1, win.y + win.height - bsh + 1
+                          , std::size_t(win.width), std::size_t(bsh) ));
+  }
+}
+
 //----------------------------------------------------------------------
 inline void FVTerm::markAsPrinted (uInt pos, uInt line)
 {
@@ -2877,10 +3856,71 @@ inline void FVTerm::newFontChanges (FChar*& next_char)
 }
 
 //----------------------------------------------------------------------
-inline void FVTerm::charsetChanges (FChar*& next_char)
+inline const FVTerm::FEncodedChar& FVTerm::charsetChanges (FChar*& next_char)
 {
-  wchar_t& ch = next_char->ch;
-  next_char->encoded_char = ch;
+  const auto& enc_char = getEncodedChar(next_char->ch);
+
+  if ( enc_char.alt_charset )
+    next_char->attr.bit.alt_charset = true;
+
+  if ( enc_char.pc_charset )
+    next_char->attr.bit.pc_charset = true;
+
+  return enc_char;
+}
+
+//----------------------------------------------------------------------
+inline const FVTerm::FEncodedChar& FVTerm::getEncodedChar (wchar_t ch)
+{
+  // Gets the terminal encoding and the output bytes of a character
+  // from a direct-mapped cache that is shared by all frames
+
+  if ( encoded_char_cache_encoding != getEncoding() )
+    clearEncodedCharCache();
+
+  auto& enc_char = encoded_char_cache[uInt(ch) % ENCODED_CHAR_CACHE_SIZE];
+
+  if ( enc_char.ch != ch || enc_char.length == 0 )
+    encodeCharacter (ch, enc_char);
+
+  return enc_char;
+}
+
+//----------------------------------------------------------------------
+void FVTerm::encodeCharacter (wchar_t ch, FEncodedChar& enc_char)
+{
+  enc_char.ch = ch;
+  encodeCharset (enc_char);
+  wchar_t output_char = enc_char.encoded_char;
+  characterFilter (output_char);
+
+  if ( output_char < 0x80 || ! hasUTF8Output() )
+  {
+    enc_char.bytes[0] = uChar(output_char);
+    enc_char.length = 1;
+  }
+  else
+    enc_char.length = uInt8(encodeUTF8(int(output_char), enc_char.bytes));
+}
+
+//----------------------------------------------------------------------
+void FVTerm::clearEncodedCharCache()
+{
+  // Invalidates all cached characters after an encoding change
+
+  for (auto&& enc_char : encoded_char_cache)
+    enc_char.length = 0;
+
+  encoded_char_cache_encoding = getEncoding();
+}
+
+//----------------------------------------------------------------------
+void FVTerm::encodeCharset (FEncodedChar& enc_char)
+{
+  const wchar_t& ch = enc_char.ch;
+  enc_char.encoded_char = ch;
+  enc_char.alt_charset = false;
+  enc_char.pc_charset = false;
 
   if ( getEncoding() == fc::UTF8 )
     return;
@@ -2892,17 +3932,17 @@ inline void FVTerm::charsetChanges (FChar*& next_char)
 
   if ( ch_enc == 0 )
   {
-    next_char->encoded_char = wchar_t(FTerm::charEncode(ch, fc::ASCII));
+    enc_char.encoded_char = wchar_t(FTerm::charEncode(ch, fc::ASCII));
     return;
   }
 
-  next_char->encoded_char = ch_enc;
+  enc_char.encoded_char = ch_enc;
 
   if ( getEncoding() == fc::VT100 )
-    next_char->attr.bit.alt_charset = true;
+    enc_char.alt_charset = true;
   else if ( getEncoding() == fc::PC )
   {
-    next_char->attr.bit.pc_charset = true;
+    enc_char.pc_charset = true;
 
     if ( isPuttyTerminal() )
       return;
@@ -2910,11 +3950,11 @@ inline void FVTerm::charsetChanges (FChar*& next_char)
     if ( isXTerminal() && ch_enc < 0x20 )  // Character 0x00..0x1f
     {
       if ( hasUTF8() )
-        next_char->encoded_char = int(FTerm::charEncode(ch, fc::ASCII));
+        enc_char.encoded_char = int(FTerm::charEncode(ch, fc::ASCII));
       else
       {
-        next_char->encoded_char += 0x5f;
-        next_char->attr.bit.alt_charset = true;
+        enc_char.encoded_char += 0x5f;
+        enc_char.alt_charset = true;
       }
     }
   }
@@ -2939,10 +3979,19 @@ inline void FVTerm::appendCharacter (FChar*& next_char)
 inline void FVTerm::appendChar (FChar*& next_char)
 {
   newFontChanges (next_char);
-  charsetChanges (next_char);
+  const auto& enc_char = charsetChanges (next_char);
   appendAttributes (next_char);
-  characterFilter (next_char);
-  appendOutputBuffer (next_char->encoded_char);
+
+  if ( next_char->attr.bit.invisible
+    && FTerm::getFOptiAttr()->isInvisibleSimulated(next_char) )
+  {
+    // Simulate invisible characters with spaces
+    wchar_t space = L' ';
+    characterFilter (space);
+    appendOutputBuffer (int(space));
+  }
+  else  // Output the pre-encoded byte sequence
+    appendOutputBuffer (enc_char.bytes, enc_char.length);
 }
 
 //----------------------------------------------------------------------
@@ -3019,12 +4068,13 @@ int FVTerm::appendLowerRight (FChar*& screen_char)
 }
 
 //----------------------------------------------------------------------
-inline void FVTerm::characterFilter (FChar*& next_char)
+inline void FVTerm::characterFilter (wchar_t& ch)
 {
   charSubstitution& sub_map = fterm->getCharSubstitutionMap();
+  const auto iter = sub_map.find(ch);
 
-  if ( sub_map.find(next_char->encoded_char) != sub_map.end() )
-    next_char->encoded_char = sub_map[next_char->encoded_char];
+  if ( iter != sub_map.end() )
+    ch = iter->second;
 }
 
 //----------------------------------------------------------------------
@@ -3044,12 +4094,79 @@ inline void FVTerm::appendOutputBuffer (const char s[])
 int FVTerm::appendOutputBuffer (int ch)
 {
   // append method for unicode character
-  output_buffer->push(ch);
+  if ( ch < 0x80 || ! hasUTF8Output() )
+  {
+    const uChar byte = uChar(ch);
+    appendOutputBuffer (&byte, 1);
+  }
+  else
+  {
+    uChar utf8_bytes[4]{};
+    appendOutputBuffer (utf8_bytes, encodeUTF8(ch, utf8_bytes));
+  }
 
-  if ( output_buffer->size() >= TERMINAL_OUTPUT_BUFFER_SIZE )
+  return ch;
+}
+
+//----------------------------------------------------------------------
+inline void FVTerm::appendOutputBuffer (const uChar bytes[], std::size_t length)
+{
+  // append method for an encoded byte sequence
+  output_buffer->append (reinterpret_cast<const char*>(bytes), length);
+
+  if ( output_buffer->length() >= TERMINAL_OUTPUT_BUFFER_SIZE
+    && ! terminal_frame_output )
     flushOutputBuffer();
+}
 
-  return ch;
+//----------------------------------------------------------------------
+std::size_t FVTerm::encodeUTF8 (int ch, uChar bytes[])
+{
+  // Writes the UTF-8 byte sequence of ch into bytes[0..3]
+  // and returns the number of bytes
+
+  if ( ch < 0x80 )
+  {
+    // 1 Byte (7-bit): 0xxxxxxx
+    bytes[0] = uChar(ch);
+    return 1;
+  }
+  else if ( ch < 0x800 )
+  {
+    // 2 byte (11-bit): 110xxxxx 10xxxxxx
+    bytes[0] = uChar(0xc0 | (ch >> 6));
+    bytes[1] = uChar(0x80 | (ch & 0x3f));
+    return 2;
+  }
+  else if ( ch < 0x10000 )
+  {
+    // 3 byte (16-bit): 1110xxxx 10xxxxxx 10xxxxxx
+    bytes[0] = uChar(0xe0 | (ch >> 12));
+    bytes[1] = uChar(0x80 | ((ch >> 6) & 0x3f));
+    bytes[2] = uChar(0x80 | (ch & 0x3f));
+    return 3;
+  }
+  else if ( ch < 0x200000 )
+  {
+    // 4 byte (21-bit): 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+    bytes[0] = uChar(0xf0 | (ch >> 18));
+    bytes[1] = uChar(0x80 | ((ch >> 12) & 0x3f));
+    bytes[2] = uChar(0x80 | ((ch >> 6) & 0x3f));
+    bytes[3] = uChar(0x80 | (ch & 0x3f));
+    return 4;
+  }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------
+inline bool FVTerm::hasUTF8Output()
+{
+  // Is FTerm::putchar() set to the UTF-8 output function?
+
+  static const auto& fterm_putchar = FTerm::putchar();
+  auto putchar_ptr = fterm_putchar.target<int(*)(int)>();
+  return putchar_ptr && *putchar_ptr == &FTerm::putchar_UTF8;
 }
 
 }  // namespace finalcut
@@ -0,0 +1,212 @@
+/***********************************************************************
+* fwatcher.cpp - Watches file descriptors for the event loop           *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <algorithm>
+
+#include "final/fwatcher.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FWatcher
+//----------------------------------------------------------------------
+
+// public methods of FWatcher
+//----------------------------------------------------------------------
+bool FWatcher::isWatched (int fd) const
+{
+  return std::any_of ( watch_list.begin(), watch_list.end()
+                     , [fd] (const FWatchData& w) { return w.fd == fd; } );
+}
+
+//----------------------------------------------------------------------
+bool FWatcher::addWatch ( int fd
+                        , int events
+                        , const FWatchCallback& callback )
+{
+  // Watches the file descriptor for the given events (read_event,
+  // write_event). A second call for the same descriptor replaces
+  // the previous watch.
+
+  if ( fd < 0 || ! callback )
+    return false;
+
+  for (auto&& watch : watch_list)
+  {
+    if ( watch.fd == fd )
+    {
+      watch.events = events;
+      watch.callback = callback;
+      return true;
+    }
+  }
+
+  watch_list.push_back({fd, events, callback});
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool FWatcher::delWatch (int fd)
+{
+  // Stops watching the file descriptor
+
+  auto iter = std::find_if ( watch_list.begin(), watch_list.end()
+                           , [fd] (const FWatchData& w)
+                             {
+                               return w.fd == fd;
+                             } );
+
+  if ( iter == watch_list.end() )
+    return false;
+
+  watch_list.erase(iter);
+  return true;
+}
+
+//----------------------------------------------------------------------
+void FWatcher::delAllWatches()
+{
+  watch_list.clear();
+  ready_list.clear();
+}
+
+//----------------------------------------------------------------------
+void FWatcher::appendPollList (FPollList& list) const
+{
+  // Adds the watched file descriptors to a poll() list
+
+  for (auto&& watch : watch_list)
+  {
+    struct pollfd p{};
+    p.fd = watch.fd;
+    p.events = toPollEvents(watch.events);
+    list.push_back(p);
+  }
+}
+
+//----------------------------------------------------------------------
+void FWatcher::setReadyEvents (const struct pollfd* fds, std::size_t n)
+{
+  // Takes the results of poll() for later dispatching
+
+  for (std::size_t i{0}; i < n; i++)
+  {
+    if ( fds[i].revents != 0 && isWatched(fds[i].fd) )
+      ready_list.emplace_back(fds[i].fd, fds[i].revents);
+  }
+}
+
+//----------------------------------------------------------------------
+int FWatcher::dispatch()
+{
+  // Calls the callback functions of the ready file descriptors
+  // and returns the number of calls
+
+  int calls{0};
+  std::vector<FReadyEvent> ready{};
+  ready.swap(ready_list);
+
+  for (auto&& event : ready)
+  {
+    const int fd = event.first;
+    const short revents = short(event.second);
+    auto iter = std::find_if ( watch_list.begin(), watch_list.end()
+                             , [fd] (const FWatchData& w)
+                               {
+                                 return w.fd == fd;
+                               } );
+
+    if ( iter == watch_list.end() )
+      continue;  // Removed by a previous callback
+
+    const int events = toWatchEvents(revents) & (iter->events | error_event);
+
+    if ( events == 0 )
+      continue;
+
+    // The callback can delete its own watch
+    const FWatchCallback callback = iter->callback;
+
+    if ( revents & POLLNVAL )
+      watch_list.erase(iter);  // The descriptor was closed
+
+    callback (fd, events);
+    calls++;
+  }
+
+  return calls;
+}
+
+//----------------------------------------------------------------------
+int FWatcher::poll (int timeout)
+{
+  // Waits for the watched file descriptors (timeout in ms) and
+  // returns the number of ready descriptors for dispatch()
+
+  if ( watch_list.empty() )
+    return 0;
+
+  poll_list.clear();
+  appendPollList (poll_list);
+  const int result = ::poll (poll_list.data(), poll_list.size(), timeout);
+
+  if ( result > 0 )
+    setReadyEvents (poll_list.data(), poll_list.size());
+
+  return ( result > 0 ) ? result : 0;
+}
+
+
+// private methods of FWatcher
+//----------------------------------------------------------------------
+short FWatcher::toPollEvents (int events)
+{
+  short poll_events{0};
+
+  if ( events & read_event )
+    poll_events |= POLLIN;
+
+  if ( events & write_event )
+    poll_events |= POLLOUT;
+
+  return poll_events;
+}
+
+//----------------------------------------------------------------------
+int FWatcher::toWatchEvents (short revents)
+{
+  int events{0};
+
+  if ( revents & POLLIN )
+    events |= read_event;
+
+  if ( revents & POLLOUT )
+    events |= write_event;
+
+  if ( revents & (POLLERR | POLLHUP | POLLNVAL) )
+    events |= error_event;
+
+  return events;
+}
+
+}  // namespace finalcut
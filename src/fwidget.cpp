@@ -20,6 +20,7 @@
 * <http://www.gnu.org/licenses/>.                                      *
 ***********************************************************************/
 
+#include <algorithm>
 #include <vector>
 
 #include "final/fapplication.h"
@@ -99,7 +100,6 @@ FWidget::~FWidget()  // destructor
 {
   processDestroy();
   delCallbacks();
-  FApplication::removeQueuedEvent(this);
 
   // unset clicked widget
   if ( this == getClickedWidget() )
@@ -159,6 +159,23 @@ FWidget* FWidget::getParentWidget() const
     return 0;
 }
 
+//----------------------------------------------------------------------
+FWidget::FSignalId FWidget::getSignalId (const FString& signal_name)
+{
+  // Returns the id of the signal name. Unknown names get the next
+  // free id, so that a signal only needs to be compared as a number.
+
+  auto& signal_map = getSignalMap();
+  const auto iter = signal_map.find(signal_name);
+
+  if ( iter != signal_map.end() )
+    return iter->second;
+
+  const auto id = FSignalId(signal_map.size() + 1);
+  signal_map[signal_name] = id;
+  return id;
+}
+
 //----------------------------------------------------------------------
 FWidget* FWidget::getFirstFocusableWidget (FObjectList list)
 {
@@ -818,23 +835,47 @@ bool FWidget::close()
 void FWidget::addCallback ( const FString& cb_signal
                           , FCallback cb_function
                           , FDataPtr data )
+{
+  addCallback (getSignalId(cb_signal), nullptr, cb_function, data);
+}
+
+//----------------------------------------------------------------------
+void FWidget::addCallback ( const FString& cb_signal
+                          , FWidget*  cb_instance
+                          , FCallback cb_function
+                          , FDataPtr data )
+{
+  addCallback (getSignalId(cb_signal), cb_instance, cb_function, data);
+}
+
+//----------------------------------------------------------------------
+void FWidget::addCallback ( FSignalId cb_signal
+                          , FCallback cb_function
+                          , FDataPtr data )
 {
   // Add a (normal) function pointer as callback
 
-  FCallbackData obj{ cb_signal, nullptr, cb_function, data };
-  callback_objects.push_back(obj);
+  addCallback (cb_signal, nullptr, cb_function, data);
 }
 
 //----------------------------------------------------------------------
-void FWidget::addCallback ( const FString& cb_signal
+void FWidget::addCallback ( FSignalId cb_signal
                           , FWidget*  cb_instance
                           , FCallback cb_function
                           , FDataPtr data )
 {
   // Add a member function pointer as callback
 
-  FCallbackData obj{ cb_signal, cb_instance, cb_function, data };
-  callback_objects.push_back(obj);
+  if ( cb_signal == 0 )
+    return;
+
+  FCallbackData obj{ cb_signal, cb_instance, cb_function, data, false };
+
+  // The callback list must not change while a signal is emitted
+  if ( callback_emit_depth > 0 )
+    added_callbacks.push_back(obj);
+  else
+    insertCallback(obj);
 }
 
 //----------------------------------------------------------------------
@@ -842,6 +883,16 @@ void FWidget::delCallback (FCallback cb_function)
 {
   // Delete cb_function form callback list
 
+  auto is_function = [this, &cb_function] (const FCallbackData& cb)
+  {
+    return getCallbackPtr(cb.cb_function) == getCallbackPtr(cb_function);
+  };
+
+  added_callbacks.erase ( std::remove_if ( added_callbacks.begin()
+                                         , added_callbacks.end()
+                                         , is_function )
+                        , added_callbacks.end() );
+
   if ( callback_objects.empty() )
     return;
 
@@ -849,10 +900,17 @@ void FWidget::delCallback (FCallback cb_function)
 
   while ( iter != callback_objects.end() )
   {
-    if ( getCallbackPtr(iter->cb_function) == getCallbackPtr(cb_function) )
-      iter = callback_objects.erase(iter);
-    else
+    if ( ! is_function(*iter) )
       ++iter;
+    else if ( callback_emit_depth > 0 )
+    {
+      // Running callbacks are removed after the emission
+      iter->removed = true;
+      callbacks_removed = true;
+      ++iter;
+    }
+    else
+      iter = callback_objects.erase(iter);
   }
 }
 
@@ -861,6 +919,16 @@ void FWidget::delCallback (FWidget* cb_instance)
 {
   // Delete all member function pointer from cb_instance
 
+  auto is_instance = [cb_instance] (const FCallbackData& cb)
+  {
+    return cb.cb_instance == cb_instance;
+  };
+
+  added_callbacks.erase ( std::remove_if ( added_callbacks.begin()
+                                         , added_callbacks.end()
+                                         , is_instance )
+                        , added_callbacks.end() );
+
   if ( callback_objects.empty() )
     return;
 
@@ -868,10 +936,17 @@ void FWidget::delCallback (FWidget* cb_instance)
 
   while ( iter != callback_objects.end() )
   {
-    if ( iter->cb_instance == cb_instance )
-      iter = callback_objects.erase(iter);
-    else
+    if ( ! is_instance(*iter) )
       ++iter;
+    else if ( callback_emit_depth > 0 )
+    {
+      // Running callbacks are removed after the emission
+      iter->removed = true;
+      callbacks_removed = true;
+      ++iter;
+    }
+    else
+      iter = callback_objects.erase(iter);
   }
 }
 
@@ -880,26 +955,65 @@ void FWidget::delCallbacks()
 {
   // Delete all callbacks from this widget
 
-  callback_objects.clear();  // function pointer
+  added_callbacks.clear();
+
+  if ( callback_emit_depth == 0 )
+  {
+    callback_objects.clear();  // function pointer
+    return;
+  }
+
+  // Running callbacks are removed after the emission
+  for (auto&& cback : callback_objects)
+    cback.removed = true;
+
+  callbacks_removed = ! callback_objects.empty();
 }
 
 //----------------------------------------------------------------------
 void FWidget::emitCallback (const FString& emit_signal)
+{
+  // A signal name without id has no callback
+
+  const auto id = findSignalId(emit_signal);
+
+  if ( id != 0 )
+    emitCallback (id);
+}
+
+//----------------------------------------------------------------------
+void FWidget::emitCallback (FSignalId emit_signal)
 {
   // Initiate callback for the given signal
 
   if ( callback_objects.empty() )
     return;
 
-  for (auto&& cback : callback_objects)
+  auto first = std::lower_bound ( callback_objects.begin()
+                                , callback_objects.end()
+                                , emit_signal
+                                , [] (const FCallbackData& cb, FSignalId id)
+                                  {
+                                    return cb.cb_signal < id;
+                                  } );
+
+  // Callbacks that add or delete callbacks of this widget during
+  // the emission only change the list after the outermost emission
+  callback_emit_depth++;
+
+  for ( auto iter = first
+      ; iter != callback_objects.end() && iter->cb_signal == emit_signal
+      ; ++iter )
   {
-    if ( cback.cb_signal == emit_signal )
-    {
-      // Calling the stored function pointer
-      auto callback = cback.cb_function;
-      callback (this, cback.data);
-    }
+    // Calling the stored function pointer
+    if ( ! iter->removed )
+      iter->cb_function (this, iter->data);
   }
+
+  callback_emit_depth--;
+
+  if ( callback_emit_depth == 0 )
+    applyCallbackChanges();
 }
 
 //----------------------------------------------------------------------
@@ -1518,6 +1632,10 @@ bool FWidget::event (FEvent* ev)
       KeyDownEvent (static_cast<FKeyEvent*>(ev));
       break;
 
+    case fc::Paste_Event:
+      onPaste (static_cast<FPasteEvent*>(ev));
+      break;
+
     case fc::MouseDown_Event:
       onMouseDown (static_cast<FMouseEvent*>(ev));
       break;
@@ -1579,7 +1697,7 @@ bool FWidget::event (FEvent* ev)
       break;
 
     default:
-      return false;
+      return FObject::event(ev);
   }
 
   return true;
@@ -1597,6 +1715,10 @@ void FWidget::onKeyUp (FKeyEvent*)
 void FWidget::onKeyDown (FKeyEvent*)
 { }
 
+//----------------------------------------------------------------------
+void FWidget::onPaste (FPasteEvent*)
+{ }
+
 //----------------------------------------------------------------------
 void FWidget::onMouseDown (FMouseEvent*)
 { }
@@ -1854,6 +1976,69 @@ void FWidget::setWindowFocus (bool enable)
   window->setWindowFocusWidget(this);
 }
 
+//----------------------------------------------------------------------
+FWidget::FSignalId FWidget::findSignalId (const FString& signal_name)
+{
+  // Returns the id of a known signal name, otherwise 0
+
+  const auto& signal_map = getSignalMap();
+  const auto iter = signal_map.find(signal_name);
+
+  if ( iter == signal_map.end() )
+    return 0;
+
+  return iter->second;
+}
+
+//----------------------------------------------------------------------
+std::map<FString, FWidget::FSignalId>& FWidget::getSignalMap()
+{
+  // The signal names of all widgets
+  static std::map<FString, FSignalId> signal_map{};
+  return signal_map;
+}
+
+//----------------------------------------------------------------------
+void FWidget::insertCallback (const FCallbackData& obj)
+{
+  // Callbacks of one signal stay in the order of their registration
+
+  auto iter = std::upper_bound ( callback_objects.begin()
+                               , callback_objects.end()
+                               , obj.cb_signal
+                               , [] (FSignalId id, const FCallbackData& cb)
+                                 {
+                                   return id < cb.cb_signal;
+                                 } );
+  callback_objects.insert(iter, obj);
+}
+
+//----------------------------------------------------------------------
+void FWidget::applyCallbackChanges()
+{
+  // Applies the callback changes made during a signal emission
+
+  if ( callbacks_removed )
+  {
+    callback_objects.erase ( std::remove_if ( callback_objects.begin()
+                                            , callback_objects.end()
+                                            , [] (const FCallbackData& cb)
+                                              {
+                                                return cb.removed;
+                                              } )
+                           , callback_objects.end() );
+    callbacks_removed = false;
+  }
+
+  if ( added_callbacks.empty() )
+    return;
+
+  for (auto&& cback : added_callbacks)
+    insertCallback(cback);
+
+  added_callbacks.clear();
+}
+
 //----------------------------------------------------------------------
 FWidget::FCallbackPtr FWidget::getCallbackPtr (FCallback cb_function)
 {
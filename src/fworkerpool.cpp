@@ -0,0 +1,276 @@
+/***********************************************************************
+* fworkerpool.cpp - Work-stealing thread pool for background tasks     *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <algorithm>
+#include <utility>
+
+#include "final/fworkerpool.h"
+
+namespace finalcut
+{
+
+namespace
+{
+
+// The pool and the worker index of the current thread
+thread_local const FWorkerPool* current_pool{nullptr};
+thread_local std::size_t current_worker{0};
+
+}  // anonymous namespace
+
+
+//----------------------------------------------------------------------
+// class FWorkerPool
+//----------------------------------------------------------------------
+
+// constructors and destructor
+//----------------------------------------------------------------------
+FWorkerPool::FWorkerPool (std::size_t num_workers)
+  : worker_count{num_workers}
+{
+  if ( worker_count == 0 )
+    worker_count = std::max(1U, std::thread::hardware_concurrency());
+}
+
+//----------------------------------------------------------------------
+FWorkerPool::~FWorkerPool()  // destructor
+{
+  stop();
+}
+
+
+// public methods of FWorkerPool
+//----------------------------------------------------------------------
+std::size_t FWorkerPool::getUnfinishedCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return unfinished;
+}
+
+//----------------------------------------------------------------------
+uInt64 FWorkerPool::getStolenCount() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return stolen;
+}
+
+//----------------------------------------------------------------------
+bool FWorkerPool::isRunning() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return running;
+}
+
+//----------------------------------------------------------------------
+bool FWorkerPool::isWorkerThread() const
+{
+  return current_pool == this;
+}
+
+//----------------------------------------------------------------------
+bool FWorkerPool::submit (const FTask& task)
+{
+  // Queues a task for a worker thread. The threads are started
+  // with the first task. A task submitted by a worker is queued
+  // in its own deque, the other tasks are distributed in turn.
+
+  if ( ! task )
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( stopped )
+      return false;
+
+    if ( ! running )
+      start();
+
+    std::size_t index{};
+
+    if ( isWorkerThread() )
+      index = current_worker;
+    else
+      index = next_worker++ % worker_count;
+
+    auto& worker = *workers[index];
+    std::lock_guard<std::mutex> worker_lock(worker.mutex);
+    worker.tasks.push_back(task);
+    queued++;
+    unfinished++;
+  }
+
+  task_ready.notify_one();
+  return true;
+}
+
+//----------------------------------------------------------------------
+void FWorkerPool::waitForIdle()
+{
+  // Blocks until all submitted tasks are finished
+
+  if ( isWorkerThread() )
+    return;  // A worker would wait for itself
+
+  std::unique_lock<std::mutex> lock(mutex);
+  all_done.wait (lock, [this] () { return unfinished == 0 || stopped; });
+}
+
+//----------------------------------------------------------------------
+void FWorkerPool::stop()
+{
+  // Waits for the running tasks and discards the queued tasks.
+  // The pool does not accept new tasks afterwards.
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( stopped )
+      return;
+
+    stopped = true;
+  }
+
+  task_ready.notify_all();
+  all_done.notify_all();
+
+  for (auto&& worker : workers)
+    if ( worker->thread.joinable() )
+      worker->thread.join();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  workers.clear();
+  queued = 0;
+  unfinished = 0;
+  running = false;
+}
+
+
+// private methods of FWorkerPool
+//----------------------------------------------------------------------
+void FWorkerPool::start()
+{
+  // Creates the worker threads (pool mutex is held)
+
+  for (std::size_t i{0}; i < worker_count; i++)
+    workers.emplace_back(new FWorker);
+
+  // All workers exist before the first thread steals from them
+  for (std::size_t i{0}; i < worker_count; i++)
+    workers[i]->thread = std::thread(&FWorkerPool::run, this, i);
+
+  running = true;
+}
+
+//----------------------------------------------------------------------
+void FWorkerPool::run (std::size_t index)
+{
+  current_pool = this;
+  current_worker = index;
+
+  while ( true )
+  {
+    FTask task{};
+
+    {
+      // Queued tasks are discarded after stop()
+      std::lock_guard<std::mutex> lock(mutex);
+
+      if ( stopped )
+        return;
+    }
+
+    if ( popTask(index, task) || stealTask(index, task) )
+    {
+      task();
+      finishTask();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    task_ready.wait (lock, [this] () { return stopped || queued > 0; });
+  }
+}
+
+//----------------------------------------------------------------------
+bool FWorkerPool::popTask (std::size_t index, FTask& task)
+{
+  // Takes the oldest task from the own deque
+
+  auto& worker = *workers[index];
+
+  {
+    std::lock_guard<std::mutex> worker_lock(worker.mutex);
+
+    if ( worker.tasks.empty() )
+      return false;
+
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  queued--;
+  return true;
+}
+
+//----------------------------------------------------------------------
+bool FWorkerPool::stealTask (std::size_t index, FTask& task)
+{
+  // Takes the newest task from the deque of another worker
+
+  for (std::size_t i{1}; i < worker_count; i++)
+  {
+    auto& victim = *workers[(index + i) % worker_count];
+
+    {
+      std::lock_guard<std::mutex> worker_lock(victim.mutex);
+
+      if ( victim.tasks.empty() )
+        continue;
+
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    queued--;
+    stolen++;
+    return true;
+  }
+
+  return false;
+}
+
+//----------------------------------------------------------------------
+void FWorkerPool::finishTask()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if ( unfinished > 0 )
+    unfinished--;
+
+  if ( unfinished == 0 )
+    all_done.notify_all();
+}
+
+}  // namespace finalcut
@@ -67,7 +67,9 @@
 #include <utility>
 
 #include "final/ftypes.h"
+#include "final/fwatcher.h"
 #include "final/fwidget.h"
+#include "final/fworkerpool.h"
 
 namespace finalcut
 {
@@ -76,9 +78,11 @@ namespace finalcut
 class FEvent;
 class FAccelEvent;
 class FCloseEvent;
+class FEventQueue;
 class FFocusEvent;
 class FKeyEvent;
 class FMouseEvent;
+class FPasteEvent;
 class FStartOptions;
 class FTimerEvent;
 class FWheelEvent;
@@ -94,6 +98,9 @@ class FObject;
 class FApplication : public FWidget
 {
   public:
+    // Typedef
+    typedef FWorkerPool::FTask FTask;
+
     // Constructor
     FApplication (const int&, char*[], bool = false);
 
@@ -123,6 +130,10 @@ class FApplication : public FWidget
     void                  quit();
     static bool           sendEvent (const FObject*, const FEvent*);
     static void           queueEvent (const FObject*, const FEvent*);
+    static void           postEvent ( const FObject*, int
+                                    , FDataPtr = nullptr );
+    static bool           runInBackground ( const FObject*, const FTask&
+                                          , const FTask& = nullptr );
     static void           sendQueuedEvents ();
     static bool           eventInQueue();
     static bool           removeQueuedEvent (const FObject*);
@@ -133,6 +144,9 @@ class FApplication : public FWidget
     #endif
                        ;
     static void           closeConfirmationDialog (FWidget*, FCloseEvent*);
+    bool                  addWatch ( int, int
+                                   , const FWatcher::FWatchCallback& );
+    bool                  delWatch (int);
 
     // Callback method
     void cb_exitApp (FWidget*, FDataPtr);
@@ -144,6 +158,7 @@ class FApplication : public FWidget
 
     // Methods
     void                  init (uInt64, uInt64);
+    static void           cancelTasks (const FObject*);
     static void           cmd_options (const int&, char*[]);
     static FStartOptions& getStartOptions();
     void                  findKeyboardWidget();
@@ -156,8 +171,11 @@ class FApplication : public FWidget
     bool                  sendKeyDownEvent (FWidget*);
     bool                  sendKeyPressEvent (FWidget*);
     bool                  sendKeyUpEvent (FWidget*);
+    bool                  sendPasteEvent (FWidget*);
+    void                  sendPastedKeys (FWidget*);
     void                  sendKeyboardAccelerator();
     void                  processKeyboardEvent();
+    uInt64                getWaitingTime();
     bool                  processDialogSwitchAccelerator();
     bool                  processAccelerator (const FWidget*&);
     bool                  getMouseEvent();
@@ -180,8 +198,11 @@ class FApplication : public FWidget
                                                     , int );
     void                  sendWheelEvent (const FPoint&, const FPoint&);
     void                  processMouseEvent();
+    void                  processMouseReports (int);
     void                  processResizeEvent();
     void                  processCloseWidget();
+    uInt                  processWatchEvents();
+    uInt                  processPostedEvents();
     bool                  processNextEvent();
     void                  performTimerAction ( const FObject*
                                              , const FEvent* ) override;
@@ -191,8 +212,11 @@ class FApplication : public FWidget
     char**                app_argv;
     uInt64                key_timeout{100000};        // 100 ms
     uInt64                dblclick_interval{500000};  // 500 ms
+    FWatcher              watcher{};
     static FMouseControl* mouse;
     static eventQueue*    event_queue;
+    static FEventQueue*   posted_events;
+    static FWorkerPool*   worker_pool;
     static int            quit_code;
     static bool           quit_now;
     static int            loop_level;
@@ -79,7 +79,8 @@ enum events
   Hide_Event,               // widget is hidden
   Close_Event,              // widget close
   Timer_Event,              // timer event occur
-  User_Event                // user defined event
+  User_Event,               // user defined event
+  Paste_Event               // text pasted
 };
 
 // Internal character encoding
@@ -573,6 +574,7 @@ enum metakeys : FKey
   Fkey_mouse                 = 0x02000020,  // xterm mouse
   Fkey_extended_mouse        = 0x02000021,  // SGR extended mouse
   Fkey_urxvt_mouse           = 0x02000022,  // urxvt mouse extension
+  Fkey_paste                 = 0x02000023,  // bracketed paste
   Fmkey_meta                 = 0x020000e0,  // meta key offset
   Fmkey_tab                  = 0x020000e9,  // M-tab
   Fmkey_enter                = 0x020000ea,  // M-enter
@@ -1155,7 +1157,8 @@ enum termcaps
   t_acs_chars,
   t_keypad_xmit,
   t_keypad_local,
-  t_key_mouse
+  t_key_mouse,
+  t_change_scroll_region
 };
 
 }  // namespace fc
@@ -48,6 +48,12 @@ extern const std::size_t lastCP437Item;
 extern const wchar_t halfWidth_fullWidth[][2];
 extern const std::size_t lastHalfWidthItem;
 
+extern const wchar_t zeroWidth_range[][2];
+extern const std::size_t lastZeroWidthItem;
+
+extern const wchar_t doubleWidth_range[][2];
+extern const std::size_t lastDoubleWidthItem;
+
 }  // namespace fc
 
 }  // namespace finalcut
@@ -0,0 +1,126 @@
+/***********************************************************************
+* feventqueue.h - Thread-safe queue for posted user events             *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FEventQueue ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FEVENTQUEUE_H
+#define FEVENTQUEUE_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+// class forward declaration
+class FObject;
+
+//----------------------------------------------------------------------
+// class FEventQueue
+//----------------------------------------------------------------------
+
+class FEventQueue final
+{
+  public:
+    // Typedef
+    typedef std::function<void()> FCallback;
+
+    struct FPostedEvent
+    {
+      const FObject*  receiver;
+      int             user_id;
+      FDataPtr        data;
+      FCallback       callback;  // Called instead of sending an event
+    };
+
+    // Constructor
+    FEventQueue();
+
+    // Disable copy constructor
+    FEventQueue (const FEventQueue&) = delete;
+
+    // Destructor
+    ~FEventQueue();
+
+    // Disable assignment operator (=)
+    FEventQueue& operator = (const FEventQueue&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    int                   getWakeupDescriptor() const;
+
+    // Inquiry
+    bool                  isEmpty() const;
+
+    // Methods
+    void                  post (const FObject*, int, FDataPtr = nullptr);
+    void                  post (const FObject*, const FCallback&);
+    std::size_t           collect();
+    bool                  fetch (FPostedEvent&);
+    bool                  remove (const FObject*);
+
+  private:
+    struct FNode
+    {
+      FPostedEvent  event;
+      FNode*        next;
+    };
+
+    // Methods
+    void                  push (const FPostedEvent&);
+    void                  createWakeupDescriptor();
+    void                  wakeUp();
+    void                  clearWakeup();
+
+    // Data members
+    std::atomic<FNode*>       head{nullptr};  // Lock-free stack of producers
+    std::atomic<bool>         wakeup_pending{false};
+    std::deque<FPostedEvent>  pending{};  // Only used by the consumer
+    int                       wakeup_fd[2]{-1, -1};  // Read and write end
+};
+
+// FEventQueue inline functions
+//----------------------------------------------------------------------
+inline const FString FEventQueue::getClassName() const
+{ return "FEventQueue"; }
+
+//----------------------------------------------------------------------
+inline int FEventQueue::getWakeupDescriptor() const
+{ return wakeup_fd[0]; }
+
+}  // namespace finalcut
+
+#endif  // FEVENTQUEUE_H
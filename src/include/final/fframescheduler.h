@@ -0,0 +1,169 @@
+/***********************************************************************
+* fframescheduler.h - Schedules the frames of the terminal output      *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FFrameScheduler ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FFRAMESCHEDULER_H
+#define FFRAMESCHEDULER_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <sys/time.h>  // need for timeval
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FFrameScheduler
+//----------------------------------------------------------------------
+
+class FFrameScheduler final
+{
+  public:
+    // Constructor
+    FFrameScheduler() = default;
+
+    // Disable copy constructor
+    FFrameScheduler (const FFrameScheduler&) = delete;
+
+    // Destructor
+    ~FFrameScheduler() = default;
+
+    // Disable assignment operator (=)
+    FFrameScheduler& operator = (const FFrameScheduler&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    uInt                  getMaxFrameRate() const;
+    uInt64                getFrameInterval() const;
+    uInt64                getFrameTimeBudget() const;
+    uInt64                getFrameCount() const;
+    uInt64                getCoalescedFrames() const;
+    uInt64                getDroppedFrames() const;
+    uInt64                getNextFrameDelay (const timeval&) const;
+
+    // Mutators
+    void                  setMaxFrameRate (uInt);
+    void                  setMinFrameInterval (uInt64);
+    void                  setFrameTimeBudget (uInt64);
+    void                  setRenderOnIdle (bool);
+
+    // Inquiries
+    bool                  isRenderOnIdle() const;
+    bool                  isUpdatePending() const;
+    bool                  isFrameDue (const timeval&) const;
+    bool                  isUpdateDue (const timeval&) const;
+
+    // Methods
+    bool                  requestUpdate (const timeval&);
+    void                  deferUpdate();
+    void                  clearPendingUpdate();
+    void                  countFrame (const timeval&, const timeval&);
+    void                  resetCounters();
+
+  private:
+    // Data members
+    uInt      max_frame_rate{0};       // 0 = unlimited
+    uInt64    min_frame_interval{0};   // in µs
+    uInt64    frame_time_budget{0};    // in µs, 0 = frame interval
+    uInt64    frame_count{0};
+    uInt64    coalesced_frames{0};
+    uInt64    dropped_frames{0};
+    timeval   last_frame_time{};
+    bool      render_on_idle{false};
+    bool      update_pending{false};
+};
+
+// FFrameScheduler inline functions
+//----------------------------------------------------------------------
+inline const FString FFrameScheduler::getClassName() const
+{ return "FFrameScheduler"; }
+
+//----------------------------------------------------------------------
+inline uInt FFrameScheduler::getMaxFrameRate() const
+{ return max_frame_rate; }
+
+//----------------------------------------------------------------------
+inline uInt64 FFrameScheduler::getFrameCount() const
+{ return frame_count; }
+
+//----------------------------------------------------------------------
+inline uInt64 FFrameScheduler::getCoalescedFrames() const
+{ return coalesced_frames; }
+
+//----------------------------------------------------------------------
+inline uInt64 FFrameScheduler::getDroppedFrames() const
+{ return dropped_frames; }
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::setMaxFrameRate (uInt fps)
+{ max_frame_rate = fps; }
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::setMinFrameInterval (uInt64 usec)
+{ min_frame_interval = usec; }
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::setFrameTimeBudget (uInt64 usec)
+{ frame_time_budget = usec; }
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::setRenderOnIdle (bool enable)
+{ render_on_idle = enable; }
+
+//----------------------------------------------------------------------
+inline bool FFrameScheduler::isRenderOnIdle() const
+{ return render_on_idle; }
+
+//----------------------------------------------------------------------
+inline bool FFrameScheduler::isUpdatePending() const
+{ return update_pending; }
+
+//----------------------------------------------------------------------
+inline bool FFrameScheduler::isUpdateDue (const timeval& now) const
+{ return update_pending && isFrameDue(now); }
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::deferUpdate()
+{
+  update_pending = true;
+  coalesced_frames++;
+}
+
+//----------------------------------------------------------------------
+inline void FFrameScheduler::clearPendingUpdate()
+{ update_pending = false; }
+
+}  // namespace finalcut
+
+#endif  // FFRAMESCHEDULER_H
@@ -41,10 +41,13 @@
 #include <final/fdialog.h>
 #include <final/fdialoglistmenu.h>
 #include <final/fevent.h>
+#include <final/feventqueue.h>
 #include <final/ffiledialog.h>
+#include <final/fframescheduler.h>
 #include <final/fkeyboard.h>
 #include <final/flabel.h>
 #include <final/flineedit.h>
+#include <final/flinkspeedmeter.h>
 #include <final/flistbox.h>
 #include <final/flistview.h>
 #include <final/fmenubar.h>
@@ -54,6 +57,7 @@
 #include <final/fmouse.h>
 #include <final/foptiattr.h>
 #include <final/foptimove.h>
+#include <final/foutputwriter.h>
 #include <final/fpoint.h>
 #include <final/fprogressbar.h>
 #include <final/fradiobutton.h>
@@ -68,6 +72,7 @@
 #include <final/fstring.h>
 #include <final/fswitch.h>
 #include <final/fsystem.h>
+#include <final/ftaskregistry.h>
 #include <final/fterm.h>
 #include <final/ftermbuffer.h>
 #include <final/ftermcap.h>
@@ -78,13 +83,16 @@
 #include <final/ftermios.h>
 #include <final/ftermxterminal.h>
 #include <final/ftextview.h>
+#include <final/ftimerheap.h>
 #include <final/ftogglebutton.h>
 #include <final/ftooltip.h>
 #include <final/ftypes.h>
 #include <final/fvterm.h>
+#include <final/fwatcher.h>
 #include <final/fwidgetcolors.h>
 #include <final/fwidget.h>
 #include <final/fwindow.h>
+#include <final/fworkerpool.h>
 
 #if defined(UNIT_TEST)
   #include <final/ftermlinux.h>
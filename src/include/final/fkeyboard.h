@@ -37,8 +37,11 @@
 
 #include <sys/time.h>
 #include <functional>
+#include <string>
+#include <vector>
 #include "final/fstring.h"
 #include "final/ftypes.h"
+#include "final/fwatcher.h"
 
 namespace finalcut
 {
@@ -73,6 +76,138 @@ class FKeyboardCommand final
 };
 
 
+//----------------------------------------------------------------------
+// class FKeyTrie
+//----------------------------------------------------------------------
+
+class FKeyTrie final
+{
+  public:
+    // Enumeration
+    enum match_type
+    {
+      no_match,        // Unknown sequence
+      prefix_match,    // The input begins like a longer key
+      complete_match   // A key was found at the beginning of the input
+    };
+
+    struct FMatch
+    {
+      match_type   type;
+      FKey         num;     // Key of the complete match or the key
+      std::size_t  length;  // at the prefix (length 0 if there is none)
+    };
+
+    // Constructor
+    FKeyTrie() = default;
+
+    // Accessors
+    const FString         getClassName() const;
+    std::size_t           getNodeCount() const;
+
+    // Inquiry
+    bool                  isEmpty() const;
+
+    // Methods
+    bool                  insert (const char[], FKey);
+    FMatch                match (const char[], std::size_t) const;
+    void                  clear();
+
+  private:
+    // Constants
+    static constexpr uInt JUMP_TABLE_MIN{16};  // Children for a jump table
+
+    struct FNode
+    {
+      FKey   num;
+      uInt   first_child;   // 0 = none (the root is never a child)
+      uInt   next_sibling;  // 0 = none
+      uInt   children;
+      uInt   jump_table;    // 0 = none, otherwise table number + 1
+      char   byte;
+      bool   is_key;
+    };
+
+    // Methods
+    uInt                  findChild (uInt, char) const;
+    void                  addChild (uInt, char);
+    void                  createJumpTable (uInt);
+
+    // Data members
+    std::vector<FNode>    nodes{};        // nodes[0] is the root
+    std::vector<uInt>     jump_tables{};  // 256 children per table
+};
+
+// FKeyTrie inline functions
+//----------------------------------------------------------------------
+inline const FString FKeyTrie::getClassName() const
+{ return "FKeyTrie"; }
+
+//----------------------------------------------------------------------
+inline std::size_t FKeyTrie::getNodeCount() const
+{ return nodes.size(); }
+
+//----------------------------------------------------------------------
+inline bool FKeyTrie::isEmpty() const
+{ return nodes.size() <= 1; }
+
+
+//----------------------------------------------------------------------
+// class FKeyFifo
+//----------------------------------------------------------------------
+
+class FKeyFifo final
+{
+  public:
+    // Constants
+    static constexpr std::size_t MAX_SIZE{1024 * 1024};
+
+    // Constructor
+    FKeyFifo() = default;
+
+    // Accessors
+    const FString         getClassName() const;
+    const char*           getData() const;
+    std::size_t           getLength() const;
+    std::size_t           getCapacity() const;
+
+    // Inquiry
+    bool                  isEmpty() const;
+
+    // Methods
+    std::size_t           append (const char[], std::size_t);
+    void                  consume (std::size_t);
+    void                  clear();
+
+  private:
+    // Data members
+    std::vector<char>     buffer{};
+    std::size_t           head{0};    // Index of the first byte
+    std::size_t           length{0};  // Number of stored bytes
+};
+
+// FKeyFifo inline functions
+//----------------------------------------------------------------------
+inline const FString FKeyFifo::getClassName() const
+{ return "FKeyFifo"; }
+
+//----------------------------------------------------------------------
+inline const char* FKeyFifo::getData() const
+{ return buffer.data() + head; }
+
+//----------------------------------------------------------------------
+inline std::size_t FKeyFifo::getLength() const
+{ return length; }
+
+//----------------------------------------------------------------------
+inline std::size_t FKeyFifo::getCapacity() const
+{ return buffer.size(); }
+
+//----------------------------------------------------------------------
+inline bool FKeyFifo::isEmpty() const
+{ return length == 0; }
+
+
 //----------------------------------------------------------------------
 // class FKeyboard
 //----------------------------------------------------------------------
@@ -103,11 +238,15 @@ class FKeyboard final
     FKey                  getKey();
     const FString         getKeyName (FKey);
     keybuffer&            getKeyBuffer();
+    const FString&        getPasteText() const;
     timeval*              getKeyPressedTime();
+    uInt64                getKeypressTimeoutDelay (uInt64);
 
     // Mutators
     void                  setTermcapMap (fc::FKeyMap*);
     void                  setKeypressTimeout (const uInt64);
+    void                  setReadBlockingTime (const uInt64);
+    void                  setWatcher (FWatcher*);
     void                  enableUTF8();
     void                  disableUTF8();
     void                  enableMouseSequences();
@@ -118,6 +257,7 @@ class FKeyboard final
 
     // Inquiry
     bool                  isInputDataPending();
+    static bool           isControlCharacter (wchar_t);
 
     // Methods
     static void           init();
@@ -135,8 +275,10 @@ class FKeyboard final
 
     // Accessors
     FKey                  getMouseProtocolKey();
-    FKey                  getTermcapKey();
-    FKey                  getMetaKey();
+    static FKey           getMouseReportLength ( const char[], std::size_t
+                                               , std::size_t& );
+    FKey                  getBracketedPasteKey();
+    FKey                  getSequenceKey();
     FKey                  getSingleKey();
 
     // Mutators
@@ -146,11 +288,16 @@ class FKeyboard final
 
     // Inquiry
     static bool           isKeypressTimeout();
+    static bool           isPasteTimeout();
 
     // Methods
+    void                  buildKeyTrie();
+    void                  consumeInput (std::size_t);
+    void                  finishPaste();
     FKey                  UTF8decode (const char[]);
     ssize_t               readKey();
     void                  parseKeyBuffer();
+    void                  decodeKeyBuffer();
     FKey                  parseKeyString();
     FKey                  keyCorrection (const FKey&);
     void                  substringKeyHandling();
@@ -170,17 +317,23 @@ class FKeyboard final
 
     static timeval        time_keypressed;
     static uInt64         key_timeout;
+    uInt64                read_blocking_time{100000};  // 100 ms
+    FWatcher*             watcher{nullptr};
+    FWatcher::FPollList   poll_list{};
     fc::FKeyMap*          key_map{nullptr};
+    FKeyTrie              key_trie{};  // Termcap and meta key sequences
+    FKeyFifo              key_fifo{};  // Received, not yet decoded input
     FKey                  key{0};
     char                  read_buf[READ_BUF_SIZE]{'\0'};
-    char                  fifo_buf[FIFO_BUF_SIZE]{'\0'};
-    int                   fifo_offset{0};
+    char                  fifo_buf[FIFO_BUF_SIZE]{'\0'};  // Mouse sequence
+    std::string           paste_data{};  // Received bracketed paste bytes
+    FString               paste_text{};
     int                   stdin_status_flags{0};
-    bool                  fifo_in_use{false};
     bool                  input_data_pending{false};
     bool                  utf8_input{false};
     bool                  mouse_support{true};
     bool                  non_blocking_stdin{false};
+    bool                  paste_active{false};
 };
 
 // FKeyboard inline functions
@@ -196,6 +349,10 @@ inline FKey FKeyboard::getKey()
 inline FKeyboard::keybuffer& FKeyboard::getKeyBuffer()
 { return fifo_buf; }
 
+//----------------------------------------------------------------------
+inline const FString& FKeyboard::getPasteText() const
+{ return paste_text; }
+
 //----------------------------------------------------------------------
 inline timeval* FKeyboard::getKeyPressedTime()
 { return &time_keypressed; }
@@ -204,6 +361,10 @@ inline timeval* FKeyboard::getKeyPressedTime()
 inline void FKeyboard::setKeypressTimeout (const uInt64 timeout)
 { key_timeout = timeout; }
 
+//----------------------------------------------------------------------
+inline void FKeyboard::setReadBlockingTime (const uInt64 blocking_time)
+{ read_blocking_time = blocking_time; }
+
 //----------------------------------------------------------------------
 inline void FKeyboard::enableUTF8()
 { utf8_input = true; }
@@ -212,6 +373,10 @@ inline void FKeyboard::enableUTF8()
 inline void FKeyboard::disableUTF8()
 { utf8_input = false; }
 
+//----------------------------------------------------------------------
+inline void FKeyboard::setWatcher (FWatcher* w)
+{ watcher = w; }
+
 //----------------------------------------------------------------------
 inline void FKeyboard::enableMouseSequences()
 { mouse_support = true; }
@@ -235,6 +400,11 @@ inline void FKeyboard::setEscPressedCommand (FKeyboardCommand cmd)
 //----------------------------------------------------------------------
 inline bool FKeyboard::isInputDataPending()
 { return input_data_pending; }
+
+//----------------------------------------------------------------------
+inline bool FKeyboard::isControlCharacter (wchar_t ch)
+{ return ch < 0x20 || (ch >= 0x7f && ch < 0xa0); }  // C0, DEL or C1
+
 //----------------------------------------------------------------------
 inline bool FKeyboard::setNonBlockingInput()
 { return setNonBlockingInput(true); }
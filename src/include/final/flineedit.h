@@ -147,6 +147,7 @@ class FLineEdit : public FWidget
 
     // Event handlers
     void                onKeyPress (FKeyEvent*) override;
+    void                onPaste (FPasteEvent*) override;
     void                onMouseDown (FMouseEvent*) override;
     void                onMouseUp (FMouseEvent*) override;
     void                onMouseMove (FMouseEvent*) override;
@@ -198,6 +199,7 @@ class FLineEdit : public FWidget
     void                switchInsertMode();
     void                acceptInput();
     bool                keyInput (FKey);
+    bool                pasteInput (const FString&);
     wchar_t             characterFilter (const wchar_t);
     void                processActivate();
     void                processChanged();
@@ -0,0 +1,122 @@
+/***********************************************************************
+* flinkspeedmeter.h - Measures the throughput of the terminal link     *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FLinkSpeedMeter ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FLINKSPEEDMETER_H
+#define FLINKSPEEDMETER_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <sys/time.h>  // need for timeval
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+// class forward declaration
+class FSystem;
+
+//----------------------------------------------------------------------
+// class FLinkSpeedMeter
+//----------------------------------------------------------------------
+
+class FLinkSpeedMeter final
+{
+  public:
+    // Constructor
+    FLinkSpeedMeter() = default;
+
+    // Disable copy constructor
+    FLinkSpeedMeter (const FLinkSpeedMeter&) = delete;
+
+    // Destructor
+    ~FLinkSpeedMeter() = default;
+
+    // Disable assignment operator (=)
+    FLinkSpeedMeter& operator = (const FLinkSpeedMeter&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    uInt64                getLinkSpeed() const;
+    uInt                  getOutputBacklog() const;
+
+    // Mutator
+    void                  setOutput (FSystem*, int);
+
+    // Inquiry
+    bool                  isCongested() const;
+
+    // Methods
+    bool                  measure (std::size_t, uInt64, const timeval&);
+
+  private:
+    // Methods
+    uInt                  queryOutputBacklog();
+
+    // Data members
+    FSystem*  fsystem{nullptr};
+    int       output_fd{-1};
+    uInt64    link_speed{0};          // in bytes per second, 0 = unknown
+    uInt      output_backlog{0};      // in bytes
+    uInt64    bytes_since_sample{0};
+    timeval   last_sample{};
+    bool      congested{false};
+};
+
+// FLinkSpeedMeter inline functions
+//----------------------------------------------------------------------
+inline const FString FLinkSpeedMeter::getClassName() const
+{ return "FLinkSpeedMeter"; }
+
+//----------------------------------------------------------------------
+inline uInt64 FLinkSpeedMeter::getLinkSpeed() const
+{ return link_speed; }
+
+//----------------------------------------------------------------------
+inline uInt FLinkSpeedMeter::getOutputBacklog() const
+{ return output_backlog; }
+
+//----------------------------------------------------------------------
+inline void FLinkSpeedMeter::setOutput (FSystem* system, int fd)
+{
+  fsystem = system;
+  output_fd = fd;
+}
+
+//----------------------------------------------------------------------
+inline bool FLinkSpeedMeter::isCongested() const
+{ return congested; }
+
+}  // namespace finalcut
+
+#endif  // FLINKSPEEDMETER_H
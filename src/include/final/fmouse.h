@@ -128,6 +128,7 @@ class FMouse
     bool                  isWheelDown();
     bool                  isMoved();
     bool                  isInputDataPending();
+    virtual bool          hasRepeatedMotion (const FKeyboard::keybuffer&);
 
     // Methods
     static FMouse*        createMouseObject (mouse_type);
@@ -277,8 +278,9 @@ class FMouseX11 final : public FMouse
     // Accessors
     const FString        getClassName() const override;
 
-    // Inquiry
+    // Inquiries
     bool                 hasData() override;
+    bool                 hasRepeatedMotion (const FKeyboard::keybuffer&) override;
 
     // Methods
     void                 setRawData (FKeyboard::keybuffer&) override;
@@ -336,8 +338,9 @@ class FMouseSGR final : public FMouse
     // Accessors
     const FString getClassName() const override;
 
-    // Inquiry
+    // Inquiries
     bool          hasData() override;
+    bool          hasRepeatedMotion (const FKeyboard::keybuffer&) override;
 
     // Methods
     void          setRawData (FKeyboard::keybuffer&) override;
@@ -395,8 +398,9 @@ class FMouseUrxvt final : public FMouse
     // Accessors
     const FString getClassName() const override;
 
-    // Inquiry
+    // Inquiries
     bool          hasData() override;
+    bool          hasRepeatedMotion (const FKeyboard::keybuffer&) override;
 
     // Methods
     void          setRawData (FKeyboard::keybuffer&) override;
@@ -454,6 +458,7 @@ class FMouseControl
     // Accessors
     virtual const FString getClassName() const;
     FPoint&               getPos();
+    std::size_t           getCoalescedMoveCount() const;
     void                  clearEvent();
 
     // Mutators
@@ -481,6 +486,7 @@ class FMouseControl
     bool                  isWheelDown();
     bool                  isMoved();
     bool                  isInputDataPending();
+    bool                  isInputDataPending (FMouse::mouse_type);
     bool                  isGpmMouseEnabled();
 
     // Methods
@@ -506,6 +512,7 @@ class FMouseControl
     // Data member
     FMouseProtocol        mouse_protocol{};
     FPoint                zero_point{0, 0};
+    std::size_t           coalesced_moves{0};
     bool                  use_gpm_mouse{false};
     bool                  use_xterm_mouse{false};
 };
@@ -515,6 +522,10 @@ class FMouseControl
 inline const FString FMouseControl::getClassName() const
 { return "FMouseControl"; }
 
+//----------------------------------------------------------------------
+inline std::size_t FMouseControl::getCoalescedMoveCount() const
+{ return coalesced_moves; }
+
 //----------------------------------------------------------------------
 inline void FMouseControl::enableXTermMouse()
 { xtermMouse(true); }
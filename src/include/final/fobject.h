@@ -41,19 +41,22 @@
   #error "Your C++ compiler does not support the C++11 standard!"
 #endif
 
-#include <sys/time.h>  // need for gettimeofday
+#include <sys/time.h>  // need for timeval
 #include <cstdlib>
 #include <cstring>
 #include <list>
 #include <memory>
 #include <vector>
 
+#include "final/ftimerheap.h"
+
 namespace finalcut
 {
 
 // class forward declaration
 class FEvent;
 class FKeyEvent;
+class FPasteEvent;
 class FMouseEvent;
 class FWheelEvent;
 class FFocusEvent;
@@ -122,24 +125,19 @@ class FObject
     static void           getCurrentTime (timeval*);
     static bool           isTimeout (timeval*, uInt64);
     int                   addTimer (int);
+    int                   addOneShotTimer (int);
     bool                  delTimer (int);
     bool                  delOwnTimer();
     bool                  delAllTimer();
 
   protected:
-    struct FTimerData
-    {
-      int       id;
-      timeval   interval;
-      timeval   timeout;
-      FObject*  object;
-    };
-
     // Typedefs
-    typedef std::vector<FTimerData> FTimerList;
+    typedef FTimerHeap::FTimerData FTimerData;
+    typedef FTimerHeap FTimerList;
 
-    // Accessor
+    // Accessors
     FTimerList*           getTimerList() const;
+    uInt64                getNextTimerDelay (uInt64) const;
 
     // Mutator
     void                  setWidgetProperty (bool);
@@ -152,7 +150,8 @@ class FObject
     virtual void          onUserEvent (FUserEvent*);
 
   private:
-    // Method
+    // Methods
+    int                   insertTimer (int, bool);
     virtual void          performTimerAction ( const FObject*
                                              , const FEvent* );
 
@@ -131,6 +131,8 @@ class FOptiAttr final
 
     // Accessors
     const FString getClassName() const;
+    uInt64        getCacheHits() const;
+    uInt64        getCacheMisses() const;
 
     // Mutators
     void  setTermEnvironment (termEnv&);
@@ -176,6 +178,7 @@ class FOptiAttr final
 
     // Inquiry
     static bool   isNormal (FChar*&);
+    bool          isInvisibleSimulated (FChar*&);
 
     // Methods
     void          initialize();
@@ -190,6 +193,26 @@ class FOptiAttr final
       bool  caused_reset;
     } capability;
 
+    typedef struct
+    {
+      uInt64 colors;        // Colors before the change (key)
+      uInt32 attributes;    // Attributes before the change (key)
+      FColor term_fg;       // Terminal colors after the change
+      FColor term_bg;
+      FColor next_fg;       // Adjusted colors of the next character
+      FColor next_bg;
+      uInt8  term_attr[2];  // Terminal attributes after the change
+      uInt8  next_attr[2];  // Adjusted attributes of the next character
+      bool   valid;         // Entry contains a transition
+      bool   changed;       // Transition needs an escape sequence
+      char   sequence[64];  // Escape sequence of the transition
+    } transition;
+
+    // Constants
+    static constexpr int         TRANSITION_CACHE_BITS = 6;
+    static constexpr std::size_t TRANSITION_CACHE_SIZE =
+        std::size_t(1) << TRANSITION_CACHE_BITS;
+
     enum init_reset_tests
     {
       no_test         = 0x00,
@@ -264,6 +287,9 @@ class FOptiAttr final
     static bool  hasNoAttribute (FChar*&);
 
     // Methods
+    void  clearAttributeCache();
+    transition& getCachedTransition (FChar*&, FChar*&);
+    char* generateAttributeChange (FChar*&, FChar*&);
     bool  hasColorChanged (FChar*&, FChar*&);
     void  resetColor (FChar*&);
     void  prevent_no_color_video_attributes (FChar*&, bool = false);
@@ -323,6 +349,9 @@ class FOptiAttr final
     FChar      on{};
     FChar      off{};
     FChar      reset_byte_mask{};
+    transition transition_cache[TRANSITION_CACHE_SIZE]{};
+    uInt64     cache_hits{0};
+    uInt64     cache_misses{0};
 
     int        max_color{1};
     int        attr_without_color{0};
@@ -358,21 +387,41 @@ inline bool operator != ( const FChar& lhs,
 inline const FString FOptiAttr::getClassName() const
 { return "FOptiAttr"; }
 
+//----------------------------------------------------------------------
+inline uInt64 FOptiAttr::getCacheHits() const
+{ return cache_hits; }
+
+//----------------------------------------------------------------------
+inline uInt64 FOptiAttr::getCacheMisses() const
+{ return cache_misses; }
+
 //----------------------------------------------------------------------
 inline void FOptiAttr::setMaxColor (const int& c)
-{ max_color = c; }
+{
+  max_color = c;
+  clearAttributeCache();
+}
 
 //----------------------------------------------------------------------
 inline void FOptiAttr::setNoColorVideo (int attr)
-{ attr_without_color = attr; }
+{
+  attr_without_color = attr;
+  clearAttributeCache();
+}
 
 //----------------------------------------------------------------------
 inline void FOptiAttr::setDefaultColorSupport()
-{ ansi_default_color = true; }
+{
+  ansi_default_color = true;
+  clearAttributeCache();
+}
 
 //----------------------------------------------------------------------
 inline void FOptiAttr::unsetDefaultColorSupport()
-{ ansi_default_color = false; }
+{
+  ansi_default_color = false;
+  clearAttributeCache();
+}
 
 }  // namespace finalcut
 
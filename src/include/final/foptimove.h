@@ -110,6 +110,7 @@ class FOptiMove final
 
     // Accessors
     const FString getClassName() const;
+    int           getBaudRate() const;
     uInt          getCursorHomeLength() const;
     uInt          getCarriageReturnLength() const;
     uInt          getCursorToLLLength() const;
@@ -183,10 +184,15 @@ class FOptiMove final
 
     // Methods
     void          calculateCharDuration();
+    void          recalculateCapabilities();
     int           capDuration (char[], int);
     int           capDurationToLength (int);
     int           repeatedAppend (const capability&, volatile int, char*);
+    int           repeatedDuration (const capability&, int, std::size_t = 0);
     int           relativeMove (char[], int, int, int, int);
+    int           relativeMoveDuration (int, int, int, int);
+    int           verticalMoveDuration (int, int);
+    int           horizontalMoveDuration (int, int);
     int           verticalMove (char[], int, int);
     void          downMove (char[], int&, int, int);
     void          upMove (char[], int&, int, int);
@@ -195,7 +201,7 @@ class FOptiMove final
     void          leftMove (char[], int&, int, int);
 
     bool          isWideMove (int, int, int, int);
-    bool          isMethod0Faster (int&, int, int);
+    bool          isMethod0Faster (int&);
     bool          isMethod1Faster (int&, int, int, int, int);
     bool          isMethod2Faster (int&, int, int, int);
     bool          isMethod3Faster (int&, int, int);
@@ -244,6 +250,10 @@ class FOptiMove final
 inline const FString FOptiMove::getClassName() const
 { return "FOptiMove"; }
 
+//----------------------------------------------------------------------
+inline int FOptiMove::getBaudRate() const
+{ return baudrate; }
+
 //----------------------------------------------------------------------
 inline uInt FOptiMove::getCursorHomeLength() const
 { return uInt(F_cursor_home.length); }
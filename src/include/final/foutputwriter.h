@@ -0,0 +1,119 @@
+/***********************************************************************
+* foutputwriter.h - Writes the terminal output in a separate thread    *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FOutputWriter ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FOUTPUTWRITER_H
+#define FOUTPUTWRITER_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+// class forward declaration
+class FSystem;
+
+//----------------------------------------------------------------------
+// class FOutputWriter
+//----------------------------------------------------------------------
+
+class FOutputWriter final
+{
+  public:
+    // Constructor
+    FOutputWriter() = default;
+
+    // Disable copy constructor
+    FOutputWriter (const FOutputWriter&) = delete;
+
+    // Destructor
+    ~FOutputWriter();
+
+    // Disable assignment operator (=)
+    FOutputWriter& operator = (const FOutputWriter&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    uInt64                getFrameCount() const;
+    uInt64                getMergedFrames() const;
+    uInt64                getWrittenBytes() const;
+    uInt64                getWriteStallTime() const;
+    uInt64                getMaxWriteStallTime() const;
+
+    // Inquiry
+    bool                  isRunning() const;
+
+    // Methods
+    void                  start (FSystem*, int);
+    void                  stop();
+    void                  write (std::string&);
+    void                  waitForCompletion();
+
+  private:
+    // Methods
+    void                  run();
+    void                  writeFrame();
+
+    // Data members
+    FSystem*                fsystem{nullptr};
+    int                     output_fd{-1};
+    std::thread             writer_thread{};
+    mutable std::mutex      mutex{};
+    std::condition_variable frame_ready{};
+    std::condition_variable frame_written{};
+    std::string             pending_frame{};  // Back buffer
+    std::string             current_frame{};  // Front buffer
+    bool                    running{false};
+    bool                    writing{false};
+    bool                    stdio_pending{false};
+    uInt64                  frame_count{0};
+    uInt64                  merged_frames{0};
+    uInt64                  written_bytes{0};
+    uInt64                  write_stall_time{0};      // in µs
+    uInt64                  max_write_stall_time{0};  // in µs
+};
+
+// FOutputWriter inline functions
+//----------------------------------------------------------------------
+inline const FString FOutputWriter::getClassName() const
+{ return "FOutputWriter"; }
+
+}  // namespace finalcut
+
+#endif  // FOUTPUTWRITER_H
@@ -35,6 +35,9 @@
   #error "Only <final/final.h> can be included directly."
 #endif
 
+#include <sys/types.h>
+
+#include <poll.h>
 #include <pwd.h>
 #include "final/ftypes.h"
 
@@ -64,12 +67,15 @@ class FSystem
     virtual FILE* fopen (const char*, const char*) = 0;
     virtual int   fclose (FILE*) = 0;
     virtual int   putchar (int) = 0;
+    virtual ssize_t write (int, const void*, std::size_t) = 0;
+    virtual int   poll (struct pollfd*, nfds_t, int) = 0;
     virtual int   tputs (const char*, int, int (*)(int)) = 0;
     virtual uid_t getuid() = 0;
     virtual uid_t geteuid() = 0;
     virtual int   getpwuid_r ( uid_t, struct passwd*, char*
                              , size_t, struct passwd**) = 0;
     virtual char* realpath (const char*, char*) = 0;
+    std::size_t   writeAll (int, const char*, std::size_t);
 };
 
 }  // namespace finalcut
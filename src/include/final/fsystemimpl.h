@@ -170,6 +170,16 @@ class FSystemImpl : public FSystem
 #endif
     }
 
+    ssize_t write (int fd, const void* buf, std::size_t count) override
+    {
+      return ::write (fd, buf, count);
+    }
+
+    int poll (struct pollfd* fds, nfds_t nfds, int timeout) override
+    {
+      return ::poll (fds, nfds, timeout);
+    }
+
     int tputs (const char* str, int affcnt, int (*putc)(int)) override
     {
 #if defined(__sun) && defined(__SVR4)
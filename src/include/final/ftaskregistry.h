@@ -0,0 +1,94 @@
+/***********************************************************************
+* ftaskregistry.h - Background tasks with a receiver                   *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FTaskRegistry ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FTASKREGISTRY_H
+#define FTASKREGISTRY_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "final/fstring.h"
+#include "final/fworkerpool.h"
+
+namespace finalcut
+{
+
+// class forward declaration
+class FObject;
+
+//----------------------------------------------------------------------
+// class FTaskRegistry
+//----------------------------------------------------------------------
+
+class FTaskRegistry final
+{
+  public:
+    // Typedefs
+    typedef FWorkerPool::FTask FTask;
+    typedef std::function<void(const FObject*, const FTask&)> FPostFunction;
+
+    // Accessors
+    const FString         getClassName() const;
+    static std::size_t    getTaskCount (const FObject*);
+
+    // Methods
+    static bool           submit ( FWorkerPool&, const FObject*
+                                 , const FTask&, const FTask&
+                                 , const FPostFunction& );
+    static void           cancel (const FObject*);
+    static void           clear();
+
+  private:
+    // Typedef
+    typedef std::multimap<const FObject*, std::shared_ptr<bool> > receiverMap;
+
+    // Method
+    static void           remove ( const FObject*
+                                 , const std::shared_ptr<bool>& );
+
+    // Data members
+    static std::mutex     mutex;
+    static receiverMap    receivers;  // Tasks with a pending continuation
+};
+
+// FTaskRegistry inline functions
+//----------------------------------------------------------------------
+inline const FString FTaskRegistry::getClassName() const
+{ return "FTaskRegistry"; }
+
+}  // namespace finalcut
+
+#endif  // FTASKREGISTRY_H
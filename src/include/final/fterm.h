@@ -128,6 +128,7 @@ namespace finalcut
 class FKeyboard;
 class FMouseControl;
 class FOptiAttr;
+class FOutputWriter;
 class FOptiMove;
 class FStartOptions;
 class FSize;
@@ -178,6 +179,7 @@ class FTerm final
     static std::size_t     getColumnNumber();
     static const FString   getKeyName (FKey);
     static int             getTTYFileDescriptor();
+    static int             getSignalPipe();
     static char*           getTermType();
     static char*           getTermFileName();
     static int             getTabstop();
@@ -245,6 +247,7 @@ class FTerm final
 
     // Mutators
     static void            setFSystem (FSystem*);
+    static void            setOutputWriter (FOutputWriter*);
     static void            setTermType (const char[]);
     static void            setInsertCursor (bool);
     static void            redefineDefaultColors (bool);
@@ -293,6 +296,7 @@ class FTerm final
     static char*           changeAttribute ( FChar*&
                                            , FChar*& );
     static void            changeTermSizeFinished();
+    static void            clearSignalPipe();
     static void            exitWithMessage (const FString&)
     #if defined(__clang__) || defined(__GNUC__)
       __attribute__((noreturn))
@@ -352,7 +356,10 @@ class FTerm final
     void                   finish_encoding();
     static void            setSignalHandler();
     static void            resetSignalHandler();
+    static void            createSignalPipe();
+    static void            closeSignalPipe();
     static void            signal_handler (int);
+    static void            waitForOutputWriter();
 
     // Data members
     static FTermData*      data;
@@ -363,6 +370,8 @@ class FTerm final
     static FTermXTerminal* xterm;
     static FKeyboard*      keyboard;
     static FMouseControl*  mouse;
+    static FOutputWriter*  output_writer;  // Writes the FVTerm output
+    static int             signal_pipe[2];  // Wakes up the event loop
 
 #if defined(UNIT_TEST)
     #undef linux
@@ -389,6 +398,7 @@ class FTerm final
 //----------------------------------------------------------------------
 uInt env2uint (const char*);
 bool isReverseNewFontchar (wchar_t);
+int getCharacterIndex (wchar_t);
 wchar_t cp437_to_unicode (uChar);
 uChar unicode_to_cp437 (wchar_t);
 FString getFullWidth (const FString&);
@@ -411,6 +421,10 @@ inline const FString FTerm::getClassName() const
 inline void FTerm::setFSystem (FSystem* fsystem)
 { fsys = fsystem; }
 
+//----------------------------------------------------------------------
+inline void FTerm::setOutputWriter (FOutputWriter* writer)
+{ output_writer = writer; }
+
 //----------------------------------------------------------------------
 inline bool FTerm::setUTF8()
 { return setUTF8(true); }
@@ -432,6 +446,7 @@ inline void FTerm::putstringf (const char format[], Args&&... args)
   if ( ! fsys )
     getFSystem();
 
+  waitForOutputWriter();
   std::size_t count = std::size_t(size);
   std::vector<char> buf(count);
   std::snprintf (&buf[0], count, format, std::forward<Args>(args)...);
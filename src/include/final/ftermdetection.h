@@ -122,6 +122,7 @@ class FTermDetection final
     static bool           canDisplay256Colors();
     static bool           hasTerminalDetection();
     static bool           hasSetCursorStyleSupport();
+    static bool           hasSynchronizedOutputSupport();
 
     // Mutators
     static void           setAnsiTerminal (bool);
@@ -169,6 +170,9 @@ class FTermDetection final
     static char*          parseSecDA (char[]);
     static int            str2int (const FString&);
     static const FString  getSecDA();
+    static void           parseSynchronizedOutputMode();
+    static bool           canRequestDECMode();
+    static int            getDECRQM (int);
     static char*          secDA_Analysis (char[]);
     static char*          secDA_Analysis_0 (char[]);
     static char*          secDA_Analysis_1 (char[]);
@@ -192,6 +196,7 @@ class FTermDetection final
     static char           termtype[256];
     static char           ttytypename[256];
     static bool           decscusr_support;
+    static bool           sync_output_support;
     static bool           terminal_detection;
     static bool           color256;
     static int            gnome_terminal_id;
@@ -259,6 +264,10 @@ inline bool FTermDetection::canDisplay256Colors()
 inline bool FTermDetection::hasSetCursorStyleSupport()
 { return decscusr_support; }
 
+//----------------------------------------------------------------------
+inline bool FTermDetection::hasSynchronizedOutputSupport()
+{ return sync_output_support; }
+
 //----------------------------------------------------------------------
 inline bool FTermDetection::isXTerminal()
 { return terminal_type.xterm; }
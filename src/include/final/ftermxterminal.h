@@ -78,6 +78,7 @@ class FTermXTerminal final
     static void           setMouseSupport();
     static void           unsetMouseSupport();
     void                  metaSendsESC (bool);
+    void                  setBracketedPaste (bool);
 
     // Accessors
     const FString         getClassName() const;
@@ -140,10 +141,13 @@ class FTermXTerminal final
     static void           disableXTermMouse();
     void                  enableXTermMetaSendsESC();
     void                  disableXTermMetaSendsESC();
+    void                  enableXTermBracketedPaste();
+    void                  disableXTermBracketedPaste();
 
     // Data members
     static bool           mouse_support;
     bool                  meta_sends_esc{false};
+    bool                  bracketed_paste{false};
     bool                  xterm_default_colors{false};
     std::size_t           term_width{80};
     std::size_t           term_height{24};
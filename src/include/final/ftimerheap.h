@@ -0,0 +1,154 @@
+/***********************************************************************
+* ftimerheap.h - Priority queue of the object timers                   *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FTimerHeap ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FTIMERHEAP_H
+#define FTIMERHEAP_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <sys/time.h>  // need for timeval
+
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+// class forward declaration
+class FObject;
+
+//----------------------------------------------------------------------
+// class FTimerHeap
+//----------------------------------------------------------------------
+
+class FTimerHeap final
+{
+  public:
+    struct FTimerData
+    {
+      int       id;
+      timeval   interval;
+      timeval   timeout;
+      FObject*  object;
+      bool      one_shot;
+      uInt64    sequence;  // Keeps the order of equal timeouts
+    };
+
+    // Constructor
+    FTimerHeap() = default;
+
+    // Disable copy constructor
+    FTimerHeap (const FTimerHeap&) = delete;
+
+    // Destructor
+    ~FTimerHeap() = default;
+
+    // Disable assignment operator (=)
+    FTimerHeap& operator = (const FTimerHeap&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    std::size_t           size() const;
+    const FTimerData&     top() const;
+    const FTimerData*     find (int) const;
+    std::size_t           count (const FObject*) const;
+    uInt64                getSequence() const;
+
+    // Inquiry
+    bool                  empty() const;
+
+    // Methods
+    int                   insert ( FObject*, const timeval&
+                                 , const timeval&, bool = false );
+    bool                  erase (int);
+    bool                  erase (const FObject*);
+    void                  clear();
+    void                  reschedule (const timeval&);
+    void                  pop();
+
+  private:
+    // Typedefs
+    typedef std::priority_queue< int
+                               , std::vector<int>
+                               , std::greater<int> > FreeIdQueue;
+    typedef std::unordered_map< const FObject*
+                              , std::vector<int> > ObjectTimerMap;
+
+    // Constants
+    static constexpr std::size_t NOT_QUEUED = static_cast<std::size_t>(-1);
+
+    // Methods
+    bool                  isBefore (std::size_t, std::size_t) const;
+    void                  swapNodes (std::size_t, std::size_t);
+    void                  siftUp (std::size_t);
+    void                  siftDown (std::size_t);
+    void                  removeNode (std::size_t);
+    void                  unlinkObject (int, const FObject*);
+    int                   getFreeId();
+
+    // Data members
+    std::vector<FTimerData>  heap{};
+    std::vector<std::size_t> position{};  // Heap index by timer id
+    FreeIdQueue              free_ids{};
+    ObjectTimerMap           object_timers{};
+    uInt64                   sequence{0};
+};
+
+// FTimerHeap inline functions
+//----------------------------------------------------------------------
+inline const FString FTimerHeap::getClassName() const
+{ return "FTimerHeap"; }
+
+//----------------------------------------------------------------------
+inline std::size_t FTimerHeap::size() const
+{ return heap.size(); }
+
+//----------------------------------------------------------------------
+inline const FTimerHeap::FTimerData& FTimerHeap::top() const
+{ return heap.front(); }
+
+//----------------------------------------------------------------------
+inline uInt64 FTimerHeap::getSequence() const
+{ return sequence; }
+
+//----------------------------------------------------------------------
+inline bool FTimerHeap::empty() const
+{ return heap.empty(); }
+
+}  // namespace finalcut
+
+#endif  // FTIMERHEAP_H
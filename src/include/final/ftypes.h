@@ -109,7 +109,6 @@ typedef std::unordered_map<wchar_t, wchar_t> charSubstitution;
 typedef struct
 {
   wchar_t ch;            // character code
-  wchar_t encoded_char;  // encoded output character
   FColor  fg_color;      // foreground color
   FColor  bg_color;      // background color
 
@@ -48,13 +48,16 @@
   #error "Only <final/final.h> can be included directly."
 #endif
 
-#include <queue>
+#include <sys/time.h>  // need for gettimeofday
+
 #include <sstream>  // std::stringstream
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "final/fc.h"
+#include "final/fframescheduler.h"
+#include "final/flinkspeedmeter.h"
 #include "final/fterm.h"
 
 #define F_PREPROC_HANDLER(i,h) \
@@ -69,6 +72,7 @@ namespace finalcut
 class FColorPair;
 class FKeyboard;
 class FMouseControl;
+class FOutputWriter;
 class FPoint;
 class FRect;
 class FSize;
@@ -121,6 +125,14 @@ class FVTerm
       start_refresh
     };
 
+    enum output_degradation
+    {
+      no_degradation,      // Full output quality
+      reduced_frame_rate,  // Frames are paced to the link speed
+      reduced_output,      // Cursor movements are costed at the link speed
+      minimal_output       // Window shadows without transparency
+    };
+
     // Constructor
     explicit FVTerm (bool, bool = false);
 
@@ -159,6 +171,15 @@ class FVTerm
     static char*          getTermType();
     static char*          getTermFileName();
     FTerm&                getFTerm();
+    static uInt           getMaxFrameRate();
+    static uInt64         getFrameTimeBudget();
+    static uInt64         getFrameCount();
+    static uInt64         getCoalescedFrames();
+    static uInt64         getDroppedFrames();
+    static const FOutputWriter* getOutputWriter();
+    static uInt64         getLinkSpeed();
+    static uInt           getOutputBacklog();
+    static output_degradation getOutputDegradation();
 
     // Mutators
     void                  setTermXY (int, int);
@@ -239,6 +260,17 @@ class FVTerm
     static bool           setVGAFont();
     static bool           setNewFont();
     static bool           setOldFont();
+    static void           setMaxFrameRate (uInt);
+    static void           setFrameTimeBudget (uInt64);
+    static void           setRenderOnIdle (bool);
+    static void           setRenderOnIdle();
+    static void           unsetRenderOnIdle();
+    static void           setOutputThread (bool);
+    static void           setOutputThread();
+    static void           unsetOutputThread();
+    static void           setAdaptiveOutput (bool);
+    static void           setAdaptiveOutput();
+    static void           unsetAdaptiveOutput();
 
     // Inquiries
     static bool           isBold();
@@ -281,6 +313,9 @@ class FVTerm
     static bool           isCursorHideable();
     static bool           hasChangedTermSize();
     static bool           hasUTF8();
+    static bool           isRenderOnIdle();
+    static bool           hasOutputThread();
+    static bool           isAdaptiveOutput();
 
     // Methods
     virtual void          clearArea (int = ' ');
@@ -289,6 +324,7 @@ class FVTerm
     void                  putVTerm();
     void                  updateTerminal (terminal_update);
     void                  updateTerminal();
+    static void           resetFrameCounters();
     virtual void          addPreprocessingHandler ( FVTerm*
                                                   , FPreprocessingFunction );
     virtual void          delPreprocessingHandler (FVTerm*);
@@ -317,6 +353,7 @@ class FVTerm
     FTermArea*            getCurrentPrintArea() const;
     FTermArea*            getVirtualDesktop() const;
     FTermArea*            getVirtualTerminal() const;
+    static uInt64         getNextFrameDelay();
     std::size_t           getLineNumber();
     std::size_t           getColumnNumber();
     static bool           charEncodable (wchar_t);
@@ -337,6 +374,7 @@ class FVTerm
     bool                  isVirtualWindow() const;
     static bool           hasHalfBlockCharacter();
     static bool           hasShadowCharacter();
+    static bool           isTerminalUpdatePending();
 
     // Methods
 
@@ -384,9 +422,61 @@ class FVTerm
       line_completely_printed
     };
 
+    struct FEncodedChar  // Character with ready output bytes
+    {
+      wchar_t ch{L'\0'};            // Unicode character
+      wchar_t encoded_char{L'\0'};  // Character in the terminal encoding
+      uChar   bytes[4]{};           // Output byte sequence
+      uInt8   length{0};            // Number of output bytes
+      bool    alt_charset{false};   // Needs the alternate character set
+      bool    pc_charset{false};    // Needs the PC character set
+    };
+
+    struct FTerminalLines  // Lines shown on the terminal
+    {
+      std::vector<FChar>  shadow{};      // Copy of the shown characters
+      std::vector<bool>   known{};       // Shadow line is up to date
+      std::vector<uInt64> hash{};        // Hash values (0 = unknown)
+      std::vector<uInt64> vterm_hash{};  // Hash values of the vterm lines
+      int                 width{0};
+      int                 height{0};
+    };
+
+    struct FCoveringWindow  // Visible window including its shadow
+    {
+      bool contains (int px, int py) const
+      {
+        return px >= x && px < x + width && py >= y && py < y + height;
+      }
+
+      bool operator != (const FCoveringWindow& w) const
+      {
+        return area != w.area || x != w.x || y != w.y
+            || width != w.width || height != w.height;
+      }
+
+      FTermArea* area{nullptr};
+      int x{0};
+      int y{0};
+      int width{0};
+      int height{0};
+    };
+
+    struct FCoverageMap  // Top-most window of each virtual terminal cell
+    {
+      std::vector<FCoveringWindow> windows{};  // From bottom to top
+      std::vector<uInt16> owner{};  // Window number (0 = virtual desktop)
+      int width{0};
+      int height{0};
+      FTermArea* last_area{nullptr};  // Last window index lookup
+      int last_index{0};
+    };
+
     // Constants
     //   Buffer size for character output on the terminal
     static constexpr uInt TERMINAL_OUTPUT_BUFFER_SIZE = 32768;
+    //   Number of entries in the encoded character cache
+    static constexpr std::size_t ENCODED_CHAR_CACHE_SIZE = 1024;
 
     // Methods
     void                  setTextToDefault (FTermArea*, const FSize&);
@@ -395,7 +485,19 @@ class FVTerm
                                              , std::size_t );
     static bool           reallocateTextArea ( FTermArea*
                                              , std::size_t );
+    static void           updateCoverageMap();
+    static int            getCoverageIndex (FTermArea*);
     static covered_state  isCovered (const FPoint&, FTermArea*);
+    static bool           isOpaqueCharacter (const FChar*);
+    static int            getOpaqueSpan ( FTermArea*
+                                        , const FPoint&
+                                        , const FPoint&
+                                        , int );
+    static void           putOpaqueSpan ( FTermArea*
+                                        , const FPoint&
+                                        , const FPoint&
+                                        , int );
+    static int            getShownSpan (const FPoint&, int, FChar*&);
     static void           updateOverlappedColor ( FTermArea*
                                                 , const FPoint&
                                                 , const FPoint& );
@@ -454,21 +556,51 @@ class FVTerm
     bool                  printWrap (FTermArea*);
     void                  printPaddingCharacter (FTermArea*, FChar&);
     void                  updateTerminalLine (uInt);
+    static bool           isSameCharacter (const FChar&, const FChar&);
+    static uInt           findFirstDifference ( const FChar[], const FChar[]
+                                              , uInt, uInt );
+    static uInt           findLastDifference ( const FChar[], const FChar[]
+                                             , uInt, uInt );
+    static void           reduceLineChanges (uInt);
+    static void           saveTerminalLine (uInt);
+    static void           adjustTerminalLines();
+    static void           invalidateTerminalLines();
+    static uInt64         getLineHash (int);
+    bool                  canScrollTerminal();
+    void                  scrollTerminalLines();
+    bool                  findScrolledLines (int&, int&, int&);
+    void                  scrollTerminalRegion (int, int, int);
     bool                  updateTerminalCursor();
     bool                  isInsideTerminal (const FPoint&);
     bool                  isTermSizeChanged();
+    static void           beginTerminalFrame();
+    static void           endTerminalFrame();
+    static void           updateFrameInterval();
+    static void           measureLinkSpeed ( std::size_t, uInt64
+                                           , const timeval& );
+    static void           adaptOutputQuality (bool, const timeval&);
+    static output_degradation getDegradationLevel (uInt64);
+    static void           setOutputDegradation (output_degradation);
+    static void           restoreShadows();
     static void           markAsPrinted (uInt, uInt);
     static void           markAsPrinted (uInt, uInt, uInt);
     static void           newFontChanges (FChar*&);
-    static void           charsetChanges (FChar*&);
+    static const FEncodedChar& charsetChanges (FChar*&);
+    static const FEncodedChar& getEncodedChar (wchar_t);
+    static void           encodeCharacter (wchar_t, FEncodedChar&);
+    static void           clearEncodedCharCache();
+    static void           encodeCharset (FEncodedChar&);
     void                  appendCharacter (FChar*&);
     void                  appendChar (FChar*&);
     void                  appendAttributes (FChar*&);
     int                   appendLowerRight (FChar*&);
-    static void           characterFilter (FChar*&);
+    static void           characterFilter (wchar_t&);
     static void           appendOutputBuffer (const std::string&);
     static void           appendOutputBuffer (const char[]);
     static int            appendOutputBuffer (int);
+    static void           appendOutputBuffer (const uChar[], std::size_t);
+    static std::size_t    encodeUTF8 (int, uChar[]);
+    static bool           hasUTF8Output();
 
     // Data members
     FTermArea*              print_area{nullptr};        // print area for this object
@@ -479,18 +611,35 @@ class FVTerm
     static FTermArea*       vterm;        // virtual terminal
     static FTermArea*       vdesktop;     // virtual desktop
     static FTermArea*       active_area;  // active area
-    static std::queue<int>* output_buffer;
+    static std::string*     output_buffer;
+    static FOutputWriter*   output_writer;
+    static uInt64           last_written_bytes;
+    static uInt64           last_write_stall_time;
+    static FCoverageMap*    coverage_map;
+    static FTerminalLines*  terminal_lines;
     static FChar            term_attribute;
     static FChar            next_attribute;
     static FChar            s_ch;      // shadow character
     static FChar            i_ch;      // inherit background character
+    static FEncodedChar     encoded_char_cache[ENCODED_CHAR_CACHE_SIZE];
+    static fc::encoding     encoded_char_cache_encoding;
     static FPoint*          term_pos;  // terminal cursor position
     static FKeyboard*       keyboard;
     static bool             terminal_update_complete;
-    static bool             terminal_update_pending;
     static bool             force_terminal_update;
     static bool             stop_terminal_updates;
+    static bool             scheduled_terminal_update;
+    static bool             terminal_frame_output;
     static int              skipped_terminal_update;
+    static bool             adaptive_output;
+    static bool             plain_shadows;
+    static output_degradation degradation_level;
+    static output_degradation requested_degradation;
+    static uInt64           average_frame_size;  // in bytes
+    static int              saved_baud_rate;
+    static FLinkSpeedMeter  link_meter;
+    static FFrameScheduler  frame_scheduler;
+    static timeval          last_congestion;
     static uInt             erase_char_length;
     static uInt             repeat_char_length;
     static uInt             clr_bol_length;
@@ -642,6 +791,42 @@ inline char* FVTerm::getTermFileName()
 inline FTerm& FVTerm::getFTerm()
 { return *fterm; }
 
+//----------------------------------------------------------------------
+inline uInt FVTerm::getMaxFrameRate()
+{ return frame_scheduler.getMaxFrameRate(); }
+
+//----------------------------------------------------------------------
+inline uInt64 FVTerm::getFrameTimeBudget()
+{ return frame_scheduler.getFrameTimeBudget(); }
+
+//----------------------------------------------------------------------
+inline uInt64 FVTerm::getFrameCount()
+{ return frame_scheduler.getFrameCount(); }
+
+//----------------------------------------------------------------------
+inline uInt64 FVTerm::getCoalescedFrames()
+{ return frame_scheduler.getCoalescedFrames(); }
+
+//----------------------------------------------------------------------
+inline uInt64 FVTerm::getDroppedFrames()
+{ return frame_scheduler.getDroppedFrames(); }
+
+//----------------------------------------------------------------------
+inline const FOutputWriter* FVTerm::getOutputWriter()
+{ return output_writer; }
+
+//----------------------------------------------------------------------
+inline uInt64 FVTerm::getLinkSpeed()
+{ return link_meter.getLinkSpeed(); }
+
+//----------------------------------------------------------------------
+inline uInt FVTerm::getOutputBacklog()
+{ return link_meter.getOutputBacklog(); }
+
+//----------------------------------------------------------------------
+inline FVTerm::output_degradation FVTerm::getOutputDegradation()
+{ return degradation_level; }
+
 //----------------------------------------------------------------------
 inline void FVTerm::hideCursor()
 { return hideCursor(true); }
@@ -881,6 +1066,42 @@ inline bool FVTerm::setNewFont()
 inline bool FVTerm::setOldFont()
 { return FTerm::setOldFont(); }
 
+//----------------------------------------------------------------------
+inline void FVTerm::setMaxFrameRate (uInt fps)
+{ frame_scheduler.setMaxFrameRate(fps); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::setFrameTimeBudget (uInt64 usec)
+{ frame_scheduler.setFrameTimeBudget(usec); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::setRenderOnIdle (bool enable)
+{ frame_scheduler.setRenderOnIdle(enable); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::setRenderOnIdle()
+{ setRenderOnIdle(true); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::unsetRenderOnIdle()
+{ setRenderOnIdle(false); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::setOutputThread()
+{ setOutputThread(true); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::unsetOutputThread()
+{ setOutputThread(false); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::setAdaptiveOutput()
+{ setAdaptiveOutput(true); }
+
+//----------------------------------------------------------------------
+inline void FVTerm::unsetAdaptiveOutput()
+{ setAdaptiveOutput(false); }
+
 //----------------------------------------------------------------------
 inline bool FVTerm::isBold()
 { return next_attribute.attr.bit.bold; }
@@ -1041,6 +1262,18 @@ inline bool FVTerm::hasChangedTermSize()
 inline bool FVTerm::hasUTF8()
 { return FTerm::hasUTF8(); }
 
+//----------------------------------------------------------------------
+inline bool FVTerm::isRenderOnIdle()
+{ return frame_scheduler.isRenderOnIdle(); }
+
+//----------------------------------------------------------------------
+inline bool FVTerm::hasOutputThread()
+{ return bool(output_writer); }
+
+//----------------------------------------------------------------------
+inline bool FVTerm::isAdaptiveOutput()
+{ return adaptive_output; }
+
 //----------------------------------------------------------------------
 template<typename... Args>
 inline int FVTerm::printf (const FString& format, Args&&... args)
@@ -1058,6 +1291,10 @@ inline FVTerm& FVTerm::print()
 inline void FVTerm::beep()
 { FTerm::beep(); }
 
+//----------------------------------------------------------------------
+inline void FVTerm::resetFrameCounters()
+{ frame_scheduler.resetCounters(); }
+
 //----------------------------------------------------------------------
 inline void FVTerm::redefineDefaultColors (bool enable)
 { FTerm::redefineDefaultColors(enable); }
@@ -1142,6 +1379,10 @@ inline bool FVTerm::hasHalfBlockCharacter()
 inline bool FVTerm::hasShadowCharacter()
 { return FTerm::hasShadowCharacter(); }
 
+//----------------------------------------------------------------------
+inline bool FVTerm::isTerminalUpdatePending()
+{ return frame_scheduler.isUpdatePending(); }
+
 //----------------------------------------------------------------------
 inline void FVTerm::initScreenSettings()
 { FTerm::initScreenSettings(); }
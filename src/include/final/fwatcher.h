@@ -0,0 +1,134 @@
+/***********************************************************************
+* fwatcher.h - Watches file descriptors for the event loop             *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FWatcher ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FWATCHER_H
+#define FWATCHER_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <poll.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FWatcher
+//----------------------------------------------------------------------
+
+class FWatcher final
+{
+  public:
+    // Enumeration
+    enum watch_event
+    {
+      read_event  = 0x01,  // Data can be read
+      write_event = 0x02,  // Data can be written
+      error_event = 0x04   // Error or hang-up (always reported)
+    };
+
+    // Typedefs
+    typedef std::function<void(int, int)> FWatchCallback;  // (fd, events)
+    typedef std::vector<struct pollfd> FPollList;
+
+    // Constructor
+    FWatcher() = default;
+
+    // Disable copy constructor
+    FWatcher (const FWatcher&) = delete;
+
+    // Destructor
+    ~FWatcher() = default;
+
+    // Disable assignment operator (=)
+    FWatcher& operator = (const FWatcher&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    std::size_t           getWatchCount() const;
+
+    // Inquiries
+    bool                  isWatched (int) const;
+    bool                  hasReadyEvents() const;
+
+    // Methods
+    bool                  addWatch (int, int, const FWatchCallback&);
+    bool                  delWatch (int);
+    void                  delAllWatches();
+    void                  appendPollList (FPollList&) const;
+    void                  setReadyEvents (const struct pollfd*, std::size_t);
+    int                   dispatch();
+    int                   poll (int);
+
+  private:
+    // Typedef
+    typedef std::pair<int, int> FReadyEvent;  // (fd, events)
+
+    struct FWatchData
+    {
+      int             fd;
+      int             events;
+      FWatchCallback  callback;
+    };
+
+    // Methods
+    static short          toPollEvents (int);
+    static int            toWatchEvents (short);
+
+    // Data members
+    std::vector<FWatchData>  watch_list{};
+    std::vector<FReadyEvent> ready_list{};
+    FPollList                poll_list{};
+};
+
+// FWatcher inline functions
+//----------------------------------------------------------------------
+inline const FString FWatcher::getClassName() const
+{ return "FWatcher"; }
+
+//----------------------------------------------------------------------
+inline std::size_t FWatcher::getWatchCount() const
+{ return watch_list.size(); }
+
+//----------------------------------------------------------------------
+inline bool FWatcher::hasReadyEvents() const
+{ return ! ready_list.empty(); }
+
+}  // namespace finalcut
+
+#endif  // FWATCHER_H
@@ -96,6 +96,7 @@
 #endif
 
 #include <functional>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -151,6 +152,7 @@ class FWidget : public FVTerm, public FObject
     typedef void (*FCallbackPtr)(FWidget*, FDataPtr);
     typedef void (FWidget::*FMemberCallback)(FWidget*, FDataPtr);
     typedef std::function<void(FWidget*, FDataPtr)> FCallback;
+    typedef uInt FSignalId;  // Interned signal name (0 = no signal)
 
     struct FWidgetFlags  // Properties of a widget ⚑
     {
@@ -200,6 +202,7 @@ class FWidget : public FVTerm, public FObject
     static FWidgetList*&    getWindowList();
     static FMenuBar*        getMenuBar();
     static FStatusBar*      getStatusBar();
+    static FSignalId        getSignalId (const FString&);
     virtual FWidget*        getFirstFocusableWidget (FObjectList);
     virtual FWidget*        getLastFocusableWidget (FObjectList);
     const FAcceleratorList& getAcceleratorList() const;
@@ -325,10 +328,18 @@ class FWidget : public FVTerm, public FObject
                                         , FWidget*
                                         , FCallback
                                         , FDataPtr = nullptr );
+    void                    addCallback ( FSignalId
+                                        , FCallback
+                                        , FDataPtr = nullptr );
+    void                    addCallback ( FSignalId
+                                        , FWidget*
+                                        , FCallback
+                                        , FDataPtr = nullptr );
     void                    delCallback (FCallback);
     void                    delCallback (FWidget*);
     void                    delCallbacks();
     void                    emitCallback (const FString&);
+    void                    emitCallback (FSignalId);
     void                    addAccelerator (FKey);
     virtual void            addAccelerator (FKey, FWidget*);
     void                    delAccelerator ();
@@ -348,14 +359,15 @@ class FWidget : public FVTerm, public FObject
   protected:
     struct FCallbackData
     {
-      FString   cb_signal;
+      FSignalId cb_signal;
       FWidget*  cb_instance;
       FCallback cb_function;
       FDataPtr  data;
+      bool      removed;  // Deleted during the emission of a signal
     };
 
     // Typedefs
-    typedef std::vector<FCallbackData> FCallbackObjects;
+    typedef std::vector<FCallbackData> FCallbackObjects;  // Sorted by signal
 
     // Accessor
     FTermArea*              getPrintArea() override;
@@ -388,6 +400,7 @@ class FWidget : public FVTerm, public FObject
     virtual void            onKeyPress (FKeyEvent*);
     virtual void            onKeyUp (FKeyEvent*);
     virtual void            onKeyDown (FKeyEvent*);
+    virtual void            onPaste (FPasteEvent*);
     virtual void            onMouseDown (FMouseEvent*);
     virtual void            onMouseUp (FMouseEvent*);
     virtual void            onMouseDoubleClick (FMouseEvent*);
@@ -411,6 +424,10 @@ class FWidget : public FVTerm, public FObject
     void                    KeyPressEvent (FKeyEvent*);
     void                    KeyDownEvent (FKeyEvent*);
     void                    setWindowFocus (bool);
+    static FSignalId        findSignalId (const FString&);
+    static std::map<FString, FSignalId>& getSignalMap();
+    void                    insertCallback (const FCallbackData&);
+    void                    applyCallbackChanges();
     FCallbackPtr            getCallbackPtr (FCallback);
     bool                    changeFocus (FWidget*, FWidget*, fc::FocusTypes);
     void                    processDestroy();
@@ -490,6 +507,9 @@ class FWidget : public FVTerm, public FObject
     FString                 statusbar_message{};
     FAcceleratorList        accelerator_list{};
     FCallbackObjects        callback_objects{};
+    FCallbackObjects        added_callbacks{};  // Added during an emission
+    uInt                    callback_emit_depth{0};
+    bool                    callbacks_removed{false};
 
     static FStatusBar*      statusbar;
     static FMenuBar*        menubar;
@@ -1012,7 +1032,10 @@ inline uInt& FWidget::setModalDialogCounter()
 
 //----------------------------------------------------------------------
 inline void FWidget::processDestroy()
-{ emitCallback("destroy"); }
+{
+  static const FSignalId destroy = getSignalId("destroy");
+  emitCallback(destroy);
+}
 
 
 // Non-member elements for NewFont
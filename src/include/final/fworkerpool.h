@@ -0,0 +1,129 @@
+/***********************************************************************
+* fworkerpool.h - Work-stealing thread pool for background tasks       *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+/*  Standalone class
+ *  ════════════════
+ *
+ * ▕▔▔▔▔▔▔▔▔▔▔▔▔▔▏
+ * ▕ FWorkerPool ▏
+ * ▕▁▁▁▁▁▁▁▁▁▁▁▁▁▏
+ */
+
+#ifndef FWORKERPOOL_H
+#define FWORKERPOOL_H
+
+#if !defined (USE_FINAL_H) && !defined (COMPILE_FINAL_CUT)
+  #error "Only <final/final.h> can be included directly."
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "final/fstring.h"
+#include "final/ftypes.h"
+
+namespace finalcut
+{
+
+//----------------------------------------------------------------------
+// class FWorkerPool
+//----------------------------------------------------------------------
+
+class FWorkerPool final
+{
+  public:
+    // Typedef
+    typedef std::function<void()> FTask;
+
+    // Constructor
+    explicit FWorkerPool (std::size_t = 0);
+
+    // Disable copy constructor
+    FWorkerPool (const FWorkerPool&) = delete;
+
+    // Destructor
+    ~FWorkerPool();
+
+    // Disable assignment operator (=)
+    FWorkerPool& operator = (const FWorkerPool&) = delete;
+
+    // Accessors
+    const FString         getClassName() const;
+    std::size_t           getWorkerCount() const;
+    std::size_t           getUnfinishedCount() const;
+    uInt64                getStolenCount() const;
+
+    // Inquiry
+    bool                  isRunning() const;
+    bool                  isWorkerThread() const;
+
+    // Methods
+    bool                  submit (const FTask&);
+    void                  waitForIdle();
+    void                  stop();
+
+  private:
+    struct FWorker
+    {
+      std::mutex         mutex{};
+      std::deque<FTask>  tasks{};  // Owner at the front, thieves at the back
+      std::thread        thread{};
+    };
+
+    // Methods
+    void                  start();
+    void                  run (std::size_t);
+    bool                  popTask (std::size_t, FTask&);
+    bool                  stealTask (std::size_t, FTask&);
+    void                  finishTask();
+
+    // Data members
+    std::vector<std::unique_ptr<FWorker> > workers{};
+    std::size_t             worker_count{0};
+    std::size_t             next_worker{0};
+    std::size_t             queued{0};      // Tasks not yet taken
+    std::size_t             unfinished{0};  // Queued or running tasks
+    uInt64                  stolen{0};
+    mutable std::mutex      mutex{};
+    std::condition_variable task_ready{};
+    std::condition_variable all_done{};
+    bool                    running{false};
+    bool                    stopped{false};
+};
+
+// FWorkerPool inline functions
+//----------------------------------------------------------------------
+inline const FString FWorkerPool::getClassName() const
+{ return "FWorkerPool"; }
+
+//----------------------------------------------------------------------
+inline std::size_t FWorkerPool::getWorkerCount() const
+{ return worker_count; }
+
+}  // namespace finalcut
+
+#endif  // FWORKERPOOL_H
@@ -0,0 +1,321 @@
+/***********************************************************************
+* feventqueue-test.cpp - FEventQueue unit tests                        *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <poll.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+bool isReadable (int fd, int timeout)
+{
+  struct pollfd p{};
+  p.fd = fd;
+  p.events = POLLIN;
+  return ::poll(&p, 1, timeout) == 1 && (p.revents & POLLIN);
+}
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FEventQueueTest
+//----------------------------------------------------------------------
+
+class FEventQueueTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FEventQueueTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void postTest();
+    void removeTest();
+    void callbackTest();
+    void threadTest();
+    void wakeupTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FEventQueueTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (postTest);
+    CPPUNIT_TEST (removeTest);
+    CPPUNIT_TEST (callbackTest);
+    CPPUNIT_TEST (threadTest);
+    CPPUNIT_TEST (wakeupTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FEventQueueTest::classNameTest()
+{
+  const finalcut::FEventQueue q;
+  const finalcut::FString& classname = q.getClassName();
+  CPPUNIT_ASSERT ( classname == "FEventQueue" );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::noArgumentTest()
+{
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+  CPPUNIT_ASSERT ( q.isEmpty() );
+  CPPUNIT_ASSERT ( q.getWakeupDescriptor() != -1 );
+  CPPUNIT_ASSERT ( ! test::isReadable(q.getWakeupDescriptor(), 0) );
+  CPPUNIT_ASSERT ( q.collect() == 0 );
+  CPPUNIT_ASSERT ( ! q.fetch(ev) );
+  CPPUNIT_ASSERT ( ! q.remove(nullptr) );
+
+  // Events without receiver are ignored
+  q.post (nullptr, 1);
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::postTest()
+{
+  finalcut::FObject obj;
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+  const int wakeup_fd = q.getWakeupDescriptor();
+  int value{42};
+
+  q.post (&obj, 1);
+  q.post (&obj, 2, &value);
+  q.post (&obj, 3);
+  CPPUNIT_ASSERT ( ! q.isEmpty() );
+  CPPUNIT_ASSERT ( test::isReadable(wakeup_fd, 0) );
+
+  // Events are only fetched after they have been collected
+  CPPUNIT_ASSERT ( ! q.fetch(ev) );
+  CPPUNIT_ASSERT ( q.collect() == 3 );
+  CPPUNIT_ASSERT ( ! test::isReadable(wakeup_fd, 0) );
+
+  // First in, first out
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.receiver == &obj );
+  CPPUNIT_ASSERT ( ev.user_id == 1 );
+  CPPUNIT_ASSERT ( ev.data == nullptr );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.user_id == 2 );
+  CPPUNIT_ASSERT ( *static_cast<int*>(ev.data) == 42 );
+
+  // A new event wakes up the consumer again
+  q.post (&obj, 4);
+  CPPUNIT_ASSERT ( test::isReadable(wakeup_fd, 0) );
+  CPPUNIT_ASSERT ( q.collect() == 2 );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.user_id == 3 );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.user_id == 4 );
+  CPPUNIT_ASSERT ( ! q.fetch(ev) );
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::removeTest()
+{
+  finalcut::FObject obj1;
+  finalcut::FObject obj2;
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+
+  q.post (&obj1, 1);
+  q.post (&obj2, 2);
+  q.post (&obj1, 3);
+  CPPUNIT_ASSERT ( q.remove(&obj1) );
+  CPPUNIT_ASSERT ( ! q.remove(&obj1) );
+
+  // The remaining event keeps the consumer awake
+  CPPUNIT_ASSERT ( test::isReadable(q.getWakeupDescriptor(), 0) );
+  CPPUNIT_ASSERT ( q.collect() == 1 );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.receiver == &obj2 );
+  CPPUNIT_ASSERT ( ev.user_id == 2 );
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::callbackTest()
+{
+  finalcut::FObject obj1;
+  finalcut::FObject obj2;
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+  int calls{0};
+
+  // Callbacks without receiver are ignored
+  q.post (nullptr, [&calls] () { calls++; });
+  q.post (&obj1, finalcut::FEventQueue::FCallback{});
+  CPPUNIT_ASSERT ( q.isEmpty() );
+
+  q.post (&obj1, [&calls] () { calls++; });
+  q.post (&obj1, 5);
+  q.post (&obj2, [&calls] () { calls += 10; });
+  CPPUNIT_ASSERT ( q.collect() == 3 );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.receiver == &obj1 );
+  CPPUNIT_ASSERT ( ev.callback );
+  ev.callback();
+  CPPUNIT_ASSERT ( calls == 1 );
+  CPPUNIT_ASSERT ( q.fetch(ev) );
+  CPPUNIT_ASSERT ( ev.user_id == 5 );
+  CPPUNIT_ASSERT ( ! ev.callback );
+
+  // Removing the receiver drops its callbacks
+  CPPUNIT_ASSERT ( q.remove(&obj2) );
+  CPPUNIT_ASSERT ( ! q.fetch(ev) );
+  CPPUNIT_ASSERT ( calls == 1 );
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::threadTest()
+{
+  finalcut::FObject obj;
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+  constexpr int producers{4};
+  constexpr int events{20000};
+  std::vector<std::thread> threads{};
+
+  for (int p{0}; p < producers; p++)
+  {
+    threads.emplace_back ( [&q, &obj, p] ()
+                           {
+                             for (int i{0}; i < events; i++)
+                               q.post (&obj, p * events + i);
+                           } );
+  }
+
+  // Consumes the events while they are posted
+  int received{0};
+  int last_id[producers];
+
+  for (int p{0}; p < producers; p++)
+    last_id[p] = -1;
+
+  while ( received < producers * events )
+  {
+    CPPUNIT_ASSERT ( test::isReadable(q.getWakeupDescriptor(), 5000) );
+    q.collect();
+
+    while ( q.fetch(ev) )
+    {
+      const int p = ev.user_id / events;
+      const int i = ev.user_id % events;
+      CPPUNIT_ASSERT ( i > last_id[p] );  // Order of each producer
+      last_id[p] = i;
+      received++;
+    }
+  }
+
+  for (auto&& t : threads)
+    t.join();
+
+  CPPUNIT_ASSERT ( received == producers * events );
+  CPPUNIT_ASSERT ( q.collect() == 0 );
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+//----------------------------------------------------------------------
+void FEventQueueTest::wakeupTest()
+{
+  // The producer posts bursts of events while the consumer collects.
+  // An event posted between the reset of the wakeup flag and the
+  // drain of the descriptor must still wake up the consumer.
+
+  finalcut::FObject obj;
+  finalcut::FEventQueue q;
+  finalcut::FEventQueue::FPostedEvent ev{};
+  constexpr int rounds{200};
+  constexpr int burst{500};
+  std::atomic<int> received{0};
+  std::atomic<bool> lost{false};
+  bool in_order{true};
+
+  std::thread producer ( [&q, &obj, &received, &lost] ()
+                         {
+                           for (int i{0}; i < rounds && ! lost; i++)
+                           {
+                             for (int n{0}; n < burst; n++)
+                               q.post (&obj, i * burst + n);
+
+                             while ( received < (i + 1) * burst && ! lost )
+                               std::this_thread::yield();
+                           }
+                         } );
+
+  while ( received < rounds * burst )
+  {
+    if ( ! test::isReadable(q.getWakeupDescriptor(), 2000) )
+    {
+      lost = true;
+      break;
+    }
+
+    q.collect();
+
+    while ( q.fetch(ev) )
+    {
+      if ( ev.user_id != received )
+        in_order = false;
+
+      received++;
+    }
+  }
+
+  producer.join();
+  CPPUNIT_ASSERT ( ! lost );
+  CPPUNIT_ASSERT ( in_order );
+  CPPUNIT_ASSERT ( received == rounds * burst );
+  CPPUNIT_ASSERT ( q.isEmpty() );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FEventQueueTest);
+
+// The general unit test main part
+#include <main-test.inc>
@@ -0,0 +1,265 @@
+/***********************************************************************
+* fframescheduler-test.cpp - FFrameScheduler unit tests                *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+
+//----------------------------------------------------------------------
+// class FFrameSchedulerTest
+//----------------------------------------------------------------------
+
+class FFrameSchedulerTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FFrameSchedulerTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void unlimitedFrameRateTest();
+    void frameRateTest();
+    void minFrameIntervalTest();
+    void droppedFramesTest();
+    void renderOnIdleTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FFrameSchedulerTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (unlimitedFrameRateTest);
+    CPPUNIT_TEST (frameRateTest);
+    CPPUNIT_TEST (minFrameIntervalTest);
+    CPPUNIT_TEST (droppedFramesTest);
+    CPPUNIT_TEST (renderOnIdleTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::classNameTest()
+{
+  const finalcut::FFrameScheduler s;
+  const finalcut::FString& classname = s.getClassName();
+  CPPUNIT_ASSERT ( classname == "FFrameScheduler" );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::noArgumentTest()
+{
+  const finalcut::FFrameScheduler s;
+  const timeval now{1000, 0};
+  CPPUNIT_ASSERT ( s.getMaxFrameRate() == 0 );
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 0 );
+  CPPUNIT_ASSERT ( s.getFrameTimeBudget() == 0 );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 0 );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 0 );
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+  CPPUNIT_ASSERT ( s.getNextFrameDelay(now) == 0 );
+  CPPUNIT_ASSERT ( ! s.isRenderOnIdle() );
+  CPPUNIT_ASSERT ( ! s.isUpdatePending() );
+  CPPUNIT_ASSERT ( s.isFrameDue(now) );
+  CPPUNIT_ASSERT ( ! s.isUpdateDue(now) );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::unlimitedFrameRateTest()
+{
+  // Without a frame rate limit, every change is drawn immediately
+  finalcut::FFrameScheduler s;
+
+  for (int i{0}; i < 100; i++)
+  {
+    const timeval frame_start{1000, i * 10};
+    const timeval frame_end{1000, i * 10 + 5};
+    CPPUNIT_ASSERT ( s.requestUpdate(frame_start) );
+    s.countFrame (frame_start, frame_end);
+    CPPUNIT_ASSERT ( s.getNextFrameDelay(frame_end) == 0 );
+  }
+
+  CPPUNIT_ASSERT ( s.getFrameCount() == 100 );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 0 );
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+  CPPUNIT_ASSERT ( ! s.isUpdatePending() );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::frameRateTest()
+{
+  finalcut::FFrameScheduler s;
+  s.setMaxFrameRate (50);
+  CPPUNIT_ASSERT ( s.getMaxFrameRate() == 50 );
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 20000 );
+  CPPUNIT_ASSERT ( s.getFrameTimeBudget() == 20000 );
+
+  // The first frame is drawn immediately
+  CPPUNIT_ASSERT ( s.requestUpdate(timeval{1000, 0}) );
+  s.countFrame (timeval{1000, 0}, timeval{1000, 2000});
+  CPPUNIT_ASSERT ( s.getFrameCount() == 1 );
+
+  // Changes within the frame interval are coalesced
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 5000}) );
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 10000}) );
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 19999}) );
+  CPPUNIT_ASSERT ( s.isUpdatePending() );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 3 );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 1 );
+  CPPUNIT_ASSERT ( s.getNextFrameDelay(timeval{1000, 10000}) == 10000 );
+  CPPUNIT_ASSERT ( ! s.isUpdateDue(timeval{1000, 10000}) );
+
+  // The pending changes are drawn together in the next frame
+  CPPUNIT_ASSERT ( s.getNextFrameDelay(timeval{1000, 20000}) == 0 );
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 20000}) );
+  s.clearPendingUpdate();
+  s.countFrame (timeval{1000, 20000}, timeval{1000, 22000});
+  CPPUNIT_ASSERT ( ! s.isUpdatePending() );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 2 );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 3 );
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+
+  // A change after the frame interval is drawn immediately
+  CPPUNIT_ASSERT ( s.requestUpdate(timeval{1000, 45000}) );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 3 );
+
+  // A deferred change is pending regardless of the frame interval
+  s.deferUpdate();
+  CPPUNIT_ASSERT ( s.isUpdatePending() );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 4 );
+
+  s.resetCounters();
+  CPPUNIT_ASSERT ( s.getFrameCount() == 0 );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 0 );
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+
+  // Removing the limit restores the immediate drawing
+  s.setMaxFrameRate (0);
+  s.countFrame (timeval{1000, 50000}, timeval{1000, 51000});
+  CPPUNIT_ASSERT ( s.requestUpdate(timeval{1000, 51000}) );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::minFrameIntervalTest()
+{
+  // A slow terminal link can lower the frame rate further
+  finalcut::FFrameScheduler s;
+  s.setMinFrameInterval (100000);
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 100000 );
+  CPPUNIT_ASSERT ( s.getFrameTimeBudget() == 0 );
+  s.setMaxFrameRate (50);
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 100000 );
+  s.setMaxFrameRate (5);
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 200000 );
+  s.setMaxFrameRate (50);
+
+  s.countFrame (timeval{1000, 0}, timeval{1000, 1000});
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 50000}) );
+  CPPUNIT_ASSERT ( s.getNextFrameDelay(timeval{1000, 50000}) == 50000 );
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 100000}) );
+
+  s.setMinFrameInterval (0);
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 20000 );
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 50000}) );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::droppedFramesTest()
+{
+  finalcut::FFrameScheduler s;
+
+  // No frame-time budget without a frame rate limit
+  s.countFrame (timeval{1000, 0}, timeval{1001, 0});
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+
+  // A frame that takes 2.5 frame intervals drops two frame slots
+  s.setMaxFrameRate (50);
+  s.countFrame (timeval{1001, 0}, timeval{1001, 20000});
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 0 );
+  s.countFrame (timeval{1001, 20000}, timeval{1001, 70000});
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 2 );
+
+  // The frame-time budget can differ from the frame interval
+  s.setFrameTimeBudget (10000);
+  CPPUNIT_ASSERT ( s.getFrameTimeBudget() == 10000 );
+  CPPUNIT_ASSERT ( s.getFrameInterval() == 20000 );
+  s.countFrame (timeval{1001, 70000}, timeval{1001, 85000});
+  CPPUNIT_ASSERT ( s.getDroppedFrames() == 3 );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 4 );
+}
+
+//----------------------------------------------------------------------
+void FFrameSchedulerTest::renderOnIdleTest()
+{
+  // All changes wait for the processing of the pending update
+  finalcut::FFrameScheduler s;
+  s.setRenderOnIdle (true);
+  CPPUNIT_ASSERT ( s.isRenderOnIdle() );
+
+  for (int i{0}; i < 10; i++)
+    CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, i}) );
+
+  CPPUNIT_ASSERT ( s.isUpdatePending() );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 10 );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 0 );
+
+  // The pending update draws all changes in one frame
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 10}) );
+  s.clearPendingUpdate();
+  s.countFrame (timeval{1000, 10}, timeval{1000, 20});
+  CPPUNIT_ASSERT ( ! s.isUpdatePending() );
+  CPPUNIT_ASSERT ( ! s.isUpdateDue(timeval{1000, 20}) );
+  CPPUNIT_ASSERT ( s.getFrameCount() == 1 );
+
+  // Also with a frame rate limit, only at the next frame interval
+  s.setMaxFrameRate (50);
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 30000}) );
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 30000}) );
+  CPPUNIT_ASSERT ( s.getCoalescedFrames() == 11 );
+  s.clearPendingUpdate();
+  s.countFrame (timeval{1000, 30000}, timeval{1000, 31000});
+  CPPUNIT_ASSERT ( ! s.requestUpdate(timeval{1000, 40000}) );
+  CPPUNIT_ASSERT ( ! s.isUpdateDue(timeval{1000, 40000}) );
+  CPPUNIT_ASSERT ( s.isUpdateDue(timeval{1000, 50000}) );
+
+  // Without render on idle, the changes are drawn immediately again
+  s.setRenderOnIdle (false);
+  CPPUNIT_ASSERT ( ! s.isRenderOnIdle() );
+  CPPUNIT_ASSERT ( s.requestUpdate(timeval{1000, 50000}) );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FFrameSchedulerTest);
+
+// The general unit test main part
+#include <main-test.inc>
@@ -28,7 +28,12 @@
 #include <cppunit/TestResultCollector.h>
 #include <cppunit/TestRunner.h>
 
+#include <unistd.h>
+
+#include <chrono>
 #include <string>
+#include <thread>
+
 #include <final/final.h>
 
 namespace test
@@ -242,6 +247,11 @@ class FKeyboardTest : public CPPUNIT_NS::TestFixture
     void mouseTest();
     void utf8Test();
     void unknownKeyTest();
+    void keyTrieTest();
+    void keyFifoTest();
+    void throughputTest();
+    void pasteTest();
+    void slowKeyProcessingTest();
 
   private:
     // Adds code needed to register the test suite
@@ -259,6 +269,11 @@ class FKeyboardTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST (mouseTest);
     CPPUNIT_TEST (utf8Test);
     CPPUNIT_TEST (unknownKeyTest);
+    CPPUNIT_TEST (keyTrieTest);
+    CPPUNIT_TEST (keyFifoTest);
+    CPPUNIT_TEST (throughputTest);
+    CPPUNIT_TEST (pasteTest);
+    CPPUNIT_TEST (slowKeyProcessingTest);
 
     // End of test suite definition
     CPPUNIT_TEST_SUITE_END();
@@ -274,6 +289,7 @@ class FKeyboardTest : public CPPUNIT_NS::TestFixture
     FKey key_pressed{0};
     FKey key_released{0};
     int  number_of_keys{0};
+    int  key_delay{0};  // Processing time of a key in µs
     finalcut::FKeyboard* keyboard{nullptr};
 };
 
@@ -2692,6 +2708,14 @@ void FKeyboardTest::mouseTest()
   CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_extended_mouse );
   clear();
 
+  // Consecutive reports are passed on together
+  input("\033[<32;11;7M\033[<32;12;7M\033[<0;12;7m");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( std::string(keyboard->getKeyBuffer())
+                   == "\033[<32;11;7M\033[<32;12;7M\033[<0;12;7m" );
+  clear();
+
   // URXVT mouse
   input("\033[32;11;7M");
   processInput();
@@ -2775,6 +2799,369 @@ void FKeyboardTest::unknownKeyTest()
   CPPUNIT_ASSERT ( keyboard->getKeyName(key_pressed) == "" );
 }
 
+//----------------------------------------------------------------------
+void FKeyboardTest::keyTrieTest()
+{
+  finalcut::FKeyTrie trie;
+  finalcut::FKeyTrie::FMatch found{};
+  CPPUNIT_ASSERT ( trie.getClassName() == "FKeyTrie" );
+  CPPUNIT_ASSERT ( trie.isEmpty() );
+  CPPUNIT_ASSERT ( trie.getNodeCount() == 0 );
+  found = trie.match("\033[A", 3);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::no_match );
+
+  CPPUNIT_ASSERT ( ! trie.insert(nullptr, finalcut::fc::Fkey_up) );
+  CPPUNIT_ASSERT ( ! trie.insert("", finalcut::fc::Fkey_up) );
+  CPPUNIT_ASSERT ( trie.insert("\033[A", finalcut::fc::Fkey_up) );
+  CPPUNIT_ASSERT ( trie.insert("\033[1;2A", finalcut::fc::Fkey_sr) );
+  CPPUNIT_ASSERT ( trie.insert("\033[", finalcut::fc::Fmkey_left_square_bracket) );
+  CPPUNIT_ASSERT ( trie.insert("\033a", finalcut::fc::Fmkey_a) );
+
+  // The first inserted key is kept
+  CPPUNIT_ASSERT ( ! trie.insert("\033[A", finalcut::fc::Fkey_down) );
+  CPPUNIT_ASSERT ( ! trie.isEmpty() );
+  CPPUNIT_ASSERT ( trie.getNodeCount() == 9 );
+
+  // Complete keys, also with following input
+  found = trie.match("\033[A", 3);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::complete_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fkey_up );
+  CPPUNIT_ASSERT ( found.length == 3 );
+  found = trie.match("\033[1;2A\033a", 8);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::complete_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fkey_sr );
+  CPPUNIT_ASSERT ( found.length == 6 );
+  found = trie.match("\033ax", 3);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::complete_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fmkey_a );
+  CPPUNIT_ASSERT ( found.length == 2 );
+
+  // Only the given length is decoded
+  found = trie.match("\033[1;2A", 4);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::prefix_match );
+  CPPUNIT_ASSERT ( found.length == 0 );
+
+  // A key that is the beginning of longer keys
+  found = trie.match("\033[", 2);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::prefix_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fmkey_left_square_bracket );
+  CPPUNIT_ASSERT ( found.length == 2 );
+  found = trie.match("\033", 1);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::prefix_match );
+  CPPUNIT_ASSERT ( found.length == 0 );
+
+  // A key that begins longer keys, followed by other input
+  found = trie.match("\033[_.", 4);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::prefix_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fmkey_left_square_bracket );
+  CPPUNIT_ASSERT ( found.length == 2 );
+  found = trie.match("\033[1;5A", 6);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::prefix_match );
+  CPPUNIT_ASSERT ( found.num == finalcut::fc::Fmkey_left_square_bracket );
+  CPPUNIT_ASSERT ( found.length == 2 );
+
+  // Unknown sequences
+  found = trie.match("\033b", 2);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::no_match );
+  found = trie.match("x", 1);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::no_match );
+  found = trie.match("\033[A", 0);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::no_match );
+
+  trie.clear();
+  CPPUNIT_ASSERT ( trie.isEmpty() );
+  found = trie.match("\033[A", 3);
+  CPPUNIT_ASSERT ( found.type == finalcut::FKeyTrie::no_match );
+}
+
+//----------------------------------------------------------------------
+void FKeyboardTest::keyFifoTest()
+{
+  finalcut::FKeyFifo fifo;
+  CPPUNIT_ASSERT ( fifo.getClassName() == "FKeyFifo" );
+  CPPUNIT_ASSERT ( fifo.isEmpty() );
+  CPPUNIT_ASSERT ( fifo.getLength() == 0 );
+  CPPUNIT_ASSERT ( fifo.getCapacity() == 0 );
+  CPPUNIT_ASSERT ( fifo.append(nullptr, 5) == 0 );
+  CPPUNIT_ASSERT ( fifo.append("abc", 0) == 0 );
+
+  // NUL bytes are regular input
+  CPPUNIT_ASSERT ( fifo.append("a\0b", 3) == 3 );
+  CPPUNIT_ASSERT ( fifo.getLength() == 3 );
+  CPPUNIT_ASSERT ( fifo.getCapacity() == 1024 );
+  CPPUNIT_ASSERT ( std::string(fifo.getData(), 3) == std::string("a\0b", 3) );
+
+  // Consuming advances the front
+  fifo.consume(2);
+  CPPUNIT_ASSERT ( fifo.getLength() == 1 );
+  CPPUNIT_ASSERT ( fifo.getData()[0] == 'b' );
+
+  // The rest is moved to the front when the end is reached
+  const std::string block(1022, '.');
+  CPPUNIT_ASSERT ( fifo.append(block.c_str(), block.length()) == 1022 );
+  CPPUNIT_ASSERT ( fifo.getLength() == 1023 );
+  CPPUNIT_ASSERT ( fifo.getCapacity() == 1024 );
+  CPPUNIT_ASSERT ( fifo.getData()[0] == 'b' );
+  CPPUNIT_ASSERT ( fifo.getData()[1022] == '.' );
+
+  // Grows with larger input
+  CPPUNIT_ASSERT ( fifo.append(block.c_str(), block.length()) == 1022 );
+  CPPUNIT_ASSERT ( fifo.getLength() == 2045 );
+  CPPUNIT_ASSERT ( fifo.getCapacity() == 2048 );
+  CPPUNIT_ASSERT ( fifo.getData()[0] == 'b' );
+
+  fifo.consume(5000);
+  CPPUNIT_ASSERT ( fifo.isEmpty() );
+  fifo.append("xyz", 3);
+  CPPUNIT_ASSERT ( fifo.getData()[0] == 'x' );
+  fifo.clear();
+  CPPUNIT_ASSERT ( fifo.isEmpty() );
+  CPPUNIT_ASSERT ( fifo.getCapacity() == 2048 );
+
+  // The size is limited
+  const std::string big(finalcut::FKeyFifo::MAX_SIZE - 10, '#');
+  CPPUNIT_ASSERT ( fifo.append(big.c_str(), big.length()) == big.length() );
+  CPPUNIT_ASSERT ( fifo.append(block.c_str(), block.length()) == 10 );
+  CPPUNIT_ASSERT ( fifo.getLength() == finalcut::FKeyFifo::MAX_SIZE );
+}
+
+//----------------------------------------------------------------------
+void FKeyboardTest::throughputTest()
+{
+  // Feeds several megabytes of text, UTF-8 characters, escape
+  // sequences and mouse reports through a pipe into the keyboard
+
+  const std::string pattern = "Hello, world! \303\274\342\202\254"
+                              ESC "OP" CSI "B" CSI "<0;11;7M" "x";
+  const int pattern_keys{20};
+  const int repetitions{100000};
+  std::string data{};
+  data.reserve (pattern.length() * repetitions);
+
+  for (int i{0}; i < repetitions; i++)
+    data += pattern;
+
+  const int stdin_no = finalcut::FTermios::getStdIn();
+  int fds[2];
+  CPPUNIT_ASSERT ( pipe(fds) == 0 );
+  const int saved_stdin = dup(stdin_no);
+  CPPUNIT_ASSERT ( dup2(fds[0], stdin_no) == stdin_no );
+  close (fds[0]);
+
+  std::thread writer ( [&data, &fds] ()
+                       {
+                         const char* p = data.c_str();
+                         std::size_t rest = data.length();
+
+                         while ( rest > 0 )
+                         {
+                           ssize_t n = write(fds[1], p, rest);
+
+                           if ( n <= 0 )
+                             break;
+
+                           p += n;
+                           rest -= std::size_t(n);
+                         }
+
+                         close (fds[1]);
+                       } );
+
+  typedef std::chrono::steady_clock clock;
+  const auto start = clock::now();
+  const auto limit = start + std::chrono::seconds(60);
+  const int expected_keys = pattern_keys * repetitions;
+
+  while ( number_of_keys < expected_keys && clock::now() < limit )
+    processInput();
+
+  const std::chrono::duration<double> elapsed = clock::now() - start;
+  writer.join();
+  dup2 (saved_stdin, stdin_no);
+  close (saved_stdin);
+
+  const double mbytes = double(data.length()) / (1024.0 * 1024.0);
+  std::cout << std::endl << " - " << mbytes << " MiB, "
+            << number_of_keys << " keys in " << elapsed.count() << " s ("
+            << mbytes / elapsed.count() << " MiB/s)" << std::endl;
+  CPPUNIT_ASSERT ( number_of_keys == expected_keys );
+  CPPUNIT_ASSERT ( key_pressed == 'x' );
+  CPPUNIT_ASSERT ( ! keyboard->isInputDataPending() );
+  clear();
+}
+
+//----------------------------------------------------------------------
+void FKeyboardTest::pasteTest()
+{
+  // Bracketed paste blocks are delivered as one key
+
+  const int stdin_no = finalcut::FTermios::getStdIn();
+  int fds[2];
+  CPPUNIT_ASSERT ( pipe(fds) == 0 );
+  const int saved_stdin = dup(stdin_no);
+  CPPUNIT_ASSERT ( dup2(fds[0], stdin_no) == stdin_no );
+  close (fds[0]);
+
+  auto send = [&fds] (const std::string& s)
+  {
+    CPPUNIT_ASSERT ( write(fds[1], s.c_str(), s.length()) == ssize_t(s.length()) );
+  };
+
+  // Line breaks and UTF-8 characters
+  send ("a" CSI "200~" "Hello\r\nworld\r\342\202\254" CSI "201~" "b");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 3 );
+  CPPUNIT_ASSERT ( key_pressed == 'b' );
+  CPPUNIT_ASSERT ( keyboard->getPasteText() == L"Hello\nworld\n\u20ac" );
+  CPPUNIT_ASSERT ( ! keyboard->isInputDataPending() );
+  clear();
+
+  // Escape sequences in the pasted text are not decoded
+  send (CSI "200~" ESC "OP" CSI "A" CSI "<0;11;7M" CSI "201~");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_paste );
+  CPPUNIT_ASSERT ( keyboard->getPasteText() == L"\033OP\033[A\033[<0;11;7M" );
+  clear();
+
+  // Markers that are split over several reads
+  send (CSI "20");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  send ("0~" "paste" CSI "20");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  send ("1~");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_paste );
+  CPPUNIT_ASSERT ( keyboard->getPasteText() == L"paste" );
+  clear();
+
+  // An empty paste
+  send (CSI "200~" CSI "201~");
+  processInput();
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_paste );
+  CPPUNIT_ASSERT ( keyboard->getPasteText().isEmpty() );
+  clear();
+
+  // A missing end marker ends the paste after a timeout
+  send (CSI "200~" "text" ESC);
+  processInput();
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  CPPUNIT_ASSERT ( keyboard->getKeypressTimeoutDelay(2000000) > 100000 );
+  usleep(1100000);
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_paste );
+  CPPUNIT_ASSERT ( keyboard->getPasteText() == L"text\033" );
+  CPPUNIT_ASSERT ( keyboard->getKeypressTimeoutDelay(2000000) == 2000000 );
+  clear();
+
+  // C0 and C1 control characters are delivered unchanged
+  // and can be dropped with isControlCharacter()
+  send ( CSI "200~" "a\001b\tc" ESC "d\302\233e\302\205f\177g\302\240h"
+         CSI "201~" );
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_paste );
+  const finalcut::FString& text = keyboard->getPasteText();
+  CPPUNIT_ASSERT ( text == L"a\001b\tc\033d\x9b" L"e\x85" L"f\177g\xa0" L"h" );
+  finalcut::FString printable{};
+
+  for (auto&& ch : text)
+    if ( ! finalcut::FKeyboard::isControlCharacter(ch) )
+      printable += ch;
+
+  CPPUNIT_ASSERT ( printable == L"abcdef" L"g\xa0" L"h" );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(L'\0') );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(L'\n') );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(0x1f) );
+  CPPUNIT_ASSERT ( ! finalcut::FKeyboard::isControlCharacter(L' ') );
+  CPPUNIT_ASSERT ( ! finalcut::FKeyboard::isControlCharacter(L'~') );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(0x7f) );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(0x80) );
+  CPPUNIT_ASSERT ( finalcut::FKeyboard::isControlCharacter(0x9f) );
+  CPPUNIT_ASSERT ( ! finalcut::FKeyboard::isControlCharacter(0xa0) );
+  CPPUNIT_ASSERT ( ! finalcut::FKeyboard::isControlCharacter(0x20ac) );
+  clear();
+
+  close (fds[1]);
+  dup2 (saved_stdin, stdin_no);
+  close (saved_stdin);
+}
+
+//----------------------------------------------------------------------
+void FKeyboardTest::slowKeyProcessingTest()
+{
+  // The processing time of the keys does not count
+  // towards the keypress timeout
+
+  const int stdin_no = finalcut::FTermios::getStdIn();
+  int fds[2];
+  CPPUNIT_ASSERT ( pipe(fds) == 0 );
+  const int saved_stdin = dup(stdin_no);
+  CPPUNIT_ASSERT ( dup2(fds[0], stdin_no) == stdin_no );
+  close (fds[0]);
+
+  auto send = [&fds] (const std::string& s)
+  {
+    CPPUNIT_ASSERT ( write(fds[1], s.c_str(), s.length()) == ssize_t(s.length()) );
+  };
+
+  // 50 keys with 5 ms each take longer than the 100 ms timeout
+  key_delay = 5000;
+  send (std::string(49, 'x') + CSI "B");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 50 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_down );
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 50 );
+  key_delay = 0;
+  clear();
+
+  // An incomplete sequence still times out
+  send (CSI "1");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  usleep(150000);
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  CPPUNIT_ASSERT ( ! keyboard->isInputDataPending() );
+  send ("a");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 1 );
+  CPPUNIT_ASSERT ( key_pressed == 'a' );
+  clear();
+
+  // Meta-O followed by other input is used after the timeout,
+  // the following input is kept
+  send (ESC "Ox");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  usleep(150000);
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 2 );
+  CPPUNIT_ASSERT ( key_pressed == 'x' );
+  CPPUNIT_ASSERT ( ! keyboard->isInputDataPending() );
+  clear();
+
+  // The same for Meta-[ before a complete key
+  send (ESC "[" CSI "B");
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 0 );
+  usleep(150000);
+  processInput();
+  CPPUNIT_ASSERT ( number_of_keys == 2 );
+  CPPUNIT_ASSERT ( key_pressed == finalcut::fc::Fkey_down );
+  clear();
+
+  close (fds[1]);
+  dup2 (saved_stdin, stdin_no);
+  close (saved_stdin);
+}
+
 //----------------------------------------------------------------------
 void FKeyboardTest::init()
 {
@@ -2846,6 +3233,9 @@ void FKeyboardTest::keyPressed()
 {
   key_pressed = keyboard->getKey();
   number_of_keys++;
+
+  if ( key_delay > 0 )
+    usleep(useconds_t(key_delay));
 }
 
 //----------------------------------------------------------------------
@@ -0,0 +1,320 @@
+/***********************************************************************
+* flinkspeedmeter-test.cpp - FLinkSpeedMeter unit tests                *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <sys/ioctl.h>
+#include <stdarg.h>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+// class FSystemTest
+//----------------------------------------------------------------------
+
+class FSystemTest : public finalcut::FSystem
+{
+  public:
+    // Constructor
+    FSystemTest() = default;
+
+    // Destructor
+    virtual ~FSystemTest() = default;
+
+    // Methods
+    uChar            inPortByte (uShort) override
+    { return 0; }
+    void             outPortByte (uChar, uShort) override
+    { }
+    int              isTTY (int) override
+    { return 1; }
+    int              ioctl (int, uLong, ...) override;
+    int              open (const char*, int, ...) override
+    { return -1; }
+    int              close (int) override
+    { return 0; }
+    FILE*            fopen (const char*, const char*) override
+    { return nullptr; }
+    int              fclose (FILE*) override
+    { return 0; }
+    int              putchar (int c) override
+    { return c; }
+    ssize_t          write (int, const void*, std::size_t n) override
+    { return ssize_t(n); }
+    int              poll (struct pollfd*, nfds_t nfds, int) override
+    { return int(nfds); }
+    int              tputs (const char*, int, int (*)(int)) override
+    { return 0; }
+    uid_t            getuid() override
+    { return 0; }
+    uid_t            geteuid() override
+    { return 0; }
+    int              getpwuid_r ( uid_t, struct passwd*, char*
+                                , size_t, struct passwd** ) override
+    { return 0; }
+    char*            realpath (const char*, char*) override
+    { return nullptr; }
+    int              getQueryCount();
+    void             setOutputQueue (int);
+
+  private:
+    // Data members
+    int output_queue{0};  // Bytes in the terminal output queue
+    int query_count{0};
+};
+
+//----------------------------------------------------------------------
+int FSystemTest::ioctl (int, uLong request, ...)
+{
+  va_list args{};
+  va_start (args, request);
+  void* argp = va_arg (args, void*);
+  int ret_val = -1;
+
+#if defined(TIOCOUTQ)
+  if ( request == TIOCOUTQ )
+  {
+    *static_cast<int*>(argp) = output_queue;
+    query_count++;
+    ret_val = 0;
+  }
+#endif
+
+  va_end (args);
+  return ret_val;
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::getQueryCount()
+{
+  return query_count;
+}
+
+//----------------------------------------------------------------------
+void FSystemTest::setOutputQueue (int queued)
+{
+  output_queue = queued;
+}
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FLinkSpeedMeterTest
+//----------------------------------------------------------------------
+
+class FLinkSpeedMeterTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FLinkSpeedMeterTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void sampleIntervalTest();
+    void drainedOutputTest();
+    void blockedWriteTest();
+    void uncountedOutputTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FLinkSpeedMeterTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+
+#if defined(TIOCOUTQ)
+    CPPUNIT_TEST (sampleIntervalTest);
+    CPPUNIT_TEST (drainedOutputTest);
+    CPPUNIT_TEST (blockedWriteTest);
+    CPPUNIT_TEST (uncountedOutputTest);
+#endif
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::classNameTest()
+{
+  const finalcut::FLinkSpeedMeter m;
+  const finalcut::FString& classname = m.getClassName();
+  CPPUNIT_ASSERT ( classname == "FLinkSpeedMeter" );
+}
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::noArgumentTest()
+{
+  finalcut::FLinkSpeedMeter m;
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 0 );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 0 );
+  CPPUNIT_ASSERT ( ! m.isCongested() );
+
+  // Without a system object there is no output queue
+  const timeval now{1000, 0};
+  CPPUNIT_ASSERT ( m.measure (4096, 0, now) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 0 );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 0 );
+  CPPUNIT_ASSERT ( ! m.isCongested() );
+}
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::sampleIntervalTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FLinkSpeedMeter m;
+  m.setOutput (&fsystem, 1);
+  fsystem.setOutputQueue (1000);
+  CPPUNIT_ASSERT ( m.measure (1000, 0, timeval{1000, 0}) );
+  CPPUNIT_ASSERT ( fsystem.getQueryCount() == 1 );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 1000 );
+
+  // The output queue is queried at most once per 100 ms
+  CPPUNIT_ASSERT ( ! m.measure (100, 0, timeval{1000, 50000}) );
+  CPPUNIT_ASSERT ( ! m.measure (100, 0, timeval{1000, 99999}) );
+  CPPUNIT_ASSERT ( fsystem.getQueryCount() == 1 );
+  CPPUNIT_ASSERT ( m.measure (100, 0, timeval{1000, 100000}) );
+  CPPUNIT_ASSERT ( fsystem.getQueryCount() == 2 );
+
+  // ...or after a blocking write()
+  CPPUNIT_ASSERT ( m.measure (100, 5000, timeval{1000, 101000}) );
+  CPPUNIT_ASSERT ( fsystem.getQueryCount() == 3 );
+}
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::drainedOutputTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FLinkSpeedMeter m;
+  m.setOutput (&fsystem, 1);
+
+  // An empty output queue gives no sample
+  fsystem.setOutputQueue (0);
+  CPPUNIT_ASSERT ( m.measure (2000, 0, timeval{1000, 0}) );
+  fsystem.setOutputQueue (500);
+  CPPUNIT_ASSERT ( m.measure (2000, 0, timeval{1000, 200000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 0 );
+  CPPUNIT_ASSERT ( ! m.isCongested() );
+
+  // 10000 bytes queued
+  fsystem.setOutputQueue (10000);
+  CPPUNIT_ASSERT ( m.measure (9500, 0, timeval{1000, 400000}) );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 10000 );
+
+  // 5000 new bytes, 12000 bytes still queued after 100 ms:
+  // 3000 bytes drained in 100 ms = 30000 bytes per second
+  fsystem.setOutputQueue (12000);
+  CPPUNIT_ASSERT ( m.measure (5000, 0, timeval{1000, 500000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 30000 );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 12000 );
+  CPPUNIT_ASSERT ( m.isCongested() );
+
+  // A second sample of 70000 bytes per second is averaged
+  fsystem.setOutputQueue (5000);
+  CPPUNIT_ASSERT ( m.measure (0, 0, timeval{1000, 600000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == (7 * 30000 + 70000) / 8 );
+
+  // All output from before the last sample was drained
+  fsystem.setOutputQueue (3000);
+  CPPUNIT_ASSERT ( m.measure (4000, 0, timeval{1000, 700000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == (7 * 30000 + 70000) / 8 );
+  CPPUNIT_ASSERT ( ! m.isCongested() );
+}
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::blockedWriteTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FLinkSpeedMeter m;
+  m.setOutput (&fsystem, 1);
+  fsystem.setOutputQueue (4096);
+  CPPUNIT_ASSERT ( m.measure (4096, 0, timeval{1000, 0}) );
+
+  // write() waited 100 ms for the full queue,
+  // 4000 of the 8000 written bytes were drained meanwhile
+  fsystem.setOutputQueue (4000);
+  CPPUNIT_ASSERT ( m.measure (8000, 100000, timeval{1000, 10000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 40000 );
+  CPPUNIT_ASSERT ( m.isCongested() );
+
+  // A blocking write() on an empty queue (e.g. a pseudo terminal)
+  // counts as congestion, but gives no sample
+  fsystem.setOutputQueue (0);
+  CPPUNIT_ASSERT ( m.measure (8000, 100000, timeval{1000, 20000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 40000 );
+  CPPUNIT_ASSERT ( m.isCongested() );
+}
+
+//----------------------------------------------------------------------
+void FLinkSpeedMeterTest::uncountedOutputTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FLinkSpeedMeter m;
+  m.setOutput (&fsystem, 1);
+  fsystem.setOutputQueue (10000);
+  CPPUNIT_ASSERT ( m.measure (10000, 0, timeval{1000, 0}) );
+  fsystem.setOutputQueue (12000);
+  CPPUNIT_ASSERT ( m.measure (5000, 0, timeval{1000, 100000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 30000 );
+
+  // The queue grew by more than the written bytes
+  // (e.g. stdio output or another writer on the terminal)
+  fsystem.setOutputQueue (50000);
+  CPPUNIT_ASSERT ( m.measure (1000, 0, timeval{1000, 200000}) );
+  CPPUNIT_ASSERT ( m.getLinkSpeed() == 30000 );
+  CPPUNIT_ASSERT ( m.getOutputBacklog() == 50000 );
+  CPPUNIT_ASSERT ( ! m.isCongested() );
+
+  // The same without a previous sample
+  finalcut::FLinkSpeedMeter m2;
+  m2.setOutput (&fsystem, 1);
+  fsystem.setOutputQueue (100);
+  CPPUNIT_ASSERT ( m2.measure (100, 0, timeval{1000, 0}) );
+  fsystem.setOutputQueue (65536);
+  CPPUNIT_ASSERT ( m2.measure (1, 0, timeval{1000, 100000}) );
+  CPPUNIT_ASSERT ( m2.getLinkSpeed() == 0 );
+  CPPUNIT_ASSERT ( ! m2.isCongested() );
+
+  // A backlog equal to the counted output gives a sample of zero
+  fsystem.setOutputQueue (65537);
+  CPPUNIT_ASSERT ( m2.measure (1, 0, timeval{1000, 200000}) );
+  CPPUNIT_ASSERT ( m2.getLinkSpeed() == 0 );
+  CPPUNIT_ASSERT ( ! m2.isCongested() );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FLinkSpeedMeterTest);
+
+// The general unit test main part
+#include <main-test.inc>
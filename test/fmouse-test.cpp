@@ -100,6 +100,7 @@ class FMouseTest : public CPPUNIT_NS::TestFixture
     void sgrMouseTest();
     void urxvtMouseTest();
     void mouseControlTest();
+    void motionCoalescingTest();
 
   private:
     // Adds code needed to register the test suite
@@ -117,6 +118,7 @@ class FMouseTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST (sgrMouseTest);
     CPPUNIT_TEST (urxvtMouseTest);
     CPPUNIT_TEST (mouseControlTest);
+    CPPUNIT_TEST (motionCoalescingTest);
 
     // End of test suite definition
     CPPUNIT_TEST_SUITE_END();
@@ -1271,6 +1273,9 @@ void FMouseTest::mouseControlTest()
 
   CPPUNIT_ASSERT ( mouse_control.hasData() );
   CPPUNIT_ASSERT ( mouse_control.isInputDataPending() );
+  CPPUNIT_ASSERT ( mouse_control.isInputDataPending(finalcut::FMouse::x11) );
+  CPPUNIT_ASSERT ( ! mouse_control.isInputDataPending(finalcut::FMouse::sgr) );
+  CPPUNIT_ASSERT ( ! mouse_control.isInputDataPending(finalcut::FMouse::gpm) );
   timeval tv;
   finalcut::FObject::getCurrentTime(&tv);
   mouse_control.processEvent (&tv);
@@ -1435,6 +1440,86 @@ void FMouseTest::mouseControlTest()
 }
 
 
+//----------------------------------------------------------------------
+void FMouseTest::motionCoalescingTest()
+{
+  finalcut::FMouseControl mouse_control;
+  mouse_control.setMaxWidth(100);
+  mouse_control.setMaxHeight(40);
+  mouse_control.useXtermMouse(true);
+  timeval tv;
+  finalcut::FObject::getCurrentTime(&tv);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 0 );
+
+  // Dragging with the left mouse button on an SGR mouse
+  finalcut::FKeyboard::keybuffer rawdata1 = \
+      { 0x1b, '[', '<', '0', ';', '1', ';', '1', 'M'
+      , 0x1b, '[', '<', '3', '2', ';', '2', ';', '1', 'M'
+      , 0x1b, '[', '<', '3', '2', ';', '3', ';', '1', 'M'
+      , 0x1b, '[', '<', '3', '2', ';', '4', ';', '2', 'M'
+      , 0x1b, '[', '<', '3', '6', ';', '5', ';', '2', 'M'
+      , 0x1b, '[', '<', '0', ';', '5', ';', '2', 'm' };
+  mouse_control.setRawData (finalcut::FMouse::sgr, rawdata1);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 0 );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isLeftButtonPressed() );
+  CPPUNIT_ASSERT ( mouse_control.getPos() == finalcut::FPoint(1, 1) );
+
+  // Only the last of three motion reports is processed
+  mouse_control.setRawData (finalcut::FMouse::sgr, rawdata1);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 2 );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isMoved() );
+  CPPUNIT_ASSERT ( mouse_control.getPos() == finalcut::FPoint(4, 2) );
+  CPPUNIT_ASSERT ( mouse_control.isInputDataPending() );
+
+  // A changed modifier key is not coalesced
+  mouse_control.setRawData (finalcut::FMouse::sgr, rawdata1);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 0 );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isShiftKeyPressed() );
+  CPPUNIT_ASSERT ( mouse_control.getPos() == finalcut::FPoint(5, 2) );
+
+  mouse_control.setRawData (finalcut::FMouse::sgr, rawdata1);
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isLeftButtonReleased() );
+  CPPUNIT_ASSERT ( ! mouse_control.isInputDataPending() );
+
+  // Motion reports on an X11 mouse
+  finalcut::FKeyboard::keybuffer rawdata2 = \
+      { 0x1b, '[', 'M', 0x40, 0x22, 0x22
+      , 0x1b, '[', 'M', 0x40, 0x23, 0x22
+      , 0x1b, '[', 'M', 0x40, 0x24, 0x23 };
+  mouse_control.setRawData (finalcut::FMouse::x11, rawdata2);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 2 );
+  CPPUNIT_ASSERT ( ! mouse_control.isInputDataPending() );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.getPos() == finalcut::FPoint(4, 3) );
+
+  // Mouse wheel reports are not coalesced
+  finalcut::FKeyboard::keybuffer rawdata3 = \
+      { 0x1b, '[', '9', '6', ';', '4', ';', '3', 'M'
+      , 0x1b, '[', '9', '6', ';', '4', ';', '3', 'M' };
+  mouse_control.setRawData (finalcut::FMouse::urxvt, rawdata3);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 0 );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isWheelUp() );
+  CPPUNIT_ASSERT ( mouse_control.isInputDataPending() );
+  mouse_control.setRawData (finalcut::FMouse::urxvt, rawdata3);
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.isWheelUp() );
+
+  // Motion reports on a urxvt mouse
+  finalcut::FKeyboard::keybuffer rawdata4 = \
+      { 0x1b, '[', '6', '4', ';', '5', ';', '5', 'M'
+      , 0x1b, '[', '6', '4', ';', '6', ';', '6', 'M' };
+  mouse_control.setRawData (finalcut::FMouse::urxvt, rawdata4);
+  CPPUNIT_ASSERT ( mouse_control.getCoalescedMoveCount() == 1 );
+  mouse_control.processEvent (&tv);
+  CPPUNIT_ASSERT ( mouse_control.getPos() == finalcut::FPoint(6, 6) );
+  CPPUNIT_ASSERT ( ! mouse_control.isInputDataPending() );
+}
+
 // Put the test suite in the registry
 CPPUNIT_TEST_SUITE_REGISTRATION (FMouseTest);
 
@@ -59,6 +59,11 @@ class FObject_protected : public finalcut::FObject
       return processTimerEvent();
     }
 
+    uInt64 getNextTimerDelay (uInt64 max_delay) const
+    {
+      return finalcut::FObject::getNextTimerDelay(max_delay);
+    }
+
     void setWidgetProperty (bool property)
     {
       finalcut::FObject::setWidgetProperty (property);
@@ -155,6 +160,8 @@ class FObjectTest : public CPPUNIT_NS::TestFixture
     void iteratorTest();
     void timeTest();
     void timerTest();
+    void timerDelayTest();
+    void oneShotTimerTest();
     void performTimerActionTest();
     void userEventTest();
 
@@ -174,6 +181,8 @@ class FObjectTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST (iteratorTest);
     CPPUNIT_TEST (timeTest);
     CPPUNIT_TEST (timerTest);
+    CPPUNIT_TEST (timerDelayTest);
+    CPPUNIT_TEST (oneShotTimerTest);
     CPPUNIT_TEST (performTimerActionTest);
     CPPUNIT_TEST (userEventTest);
 
@@ -586,6 +595,57 @@ void FObjectTest::timerTest()
   CPPUNIT_ASSERT ( ! t1.delTimer(-1) );
 }
 
+//----------------------------------------------------------------------
+void FObjectTest::timerDelayTest()
+{
+  test::FObject_protected t;
+
+  // Without timers the maximum delay is returned
+  CPPUNIT_ASSERT ( t.getNextTimerDelay(5000000) == 5000000 );
+
+  t.addTimer(900);
+  t.addTimer(300);
+  uInt64 delay = t.getNextTimerDelay(5000000);
+  CPPUNIT_ASSERT ( delay > 250000 );
+  CPPUNIT_ASSERT ( delay <= 300000 );
+  CPPUNIT_ASSERT ( t.getNextTimerDelay(1000) == 1000 );
+
+  // An expired timer does not wait
+  t.delAllTimer();
+  t.addTimer(0);
+  CPPUNIT_ASSERT ( t.getNextTimerDelay(5000000) == 0 );
+  t.delAllTimer();
+  CPPUNIT_ASSERT ( t.getNextTimerDelay(5000000) == 5000000 );
+}
+
+//----------------------------------------------------------------------
+void FObjectTest::oneShotTimerTest()
+{
+  test::FObject_protected t;
+  int id = t.addOneShotTimer(0);
+  CPPUNIT_ASSERT ( id > 0 );
+  CPPUNIT_ASSERT ( t.getTimerList()->size() == 1 );
+
+  // The timer expires only once and is removed afterwards
+  t.processEvent();
+  CPPUNIT_ASSERT ( t.count == 1 );
+  CPPUNIT_ASSERT ( t.getTimerList()->empty() );
+  t.processEvent();
+  CPPUNIT_ASSERT ( t.count == 1 );
+  CPPUNIT_ASSERT ( ! t.delTimer(id) );
+
+  // An interval timer of 0 ms fires once per call
+  t.addTimer(0);
+  t.addOneShotTimer(0);
+  t.processEvent();
+  CPPUNIT_ASSERT ( t.count == 3 );
+  CPPUNIT_ASSERT ( t.getTimerList()->size() == 1 );
+  t.processEvent();
+  CPPUNIT_ASSERT ( t.count == 4 );
+  CPPUNIT_ASSERT ( t.delOwnTimer() );
+  CPPUNIT_ASSERT ( t.getTimerList()->empty() );
+}
+
 //----------------------------------------------------------------------
 void FObjectTest::performTimerActionTest()
 {
@@ -69,6 +69,7 @@ class FOptiAttrTest : public CPPUNIT_NS::TestFixture
     void noArgumentTest();
     void vga2ansiTest();
     void fakeReverseTest();
+    void transitionCacheTest();
     void ansiTest();
     void vt100Test();
     void xtermTest();
@@ -91,6 +92,7 @@ class FOptiAttrTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST (noArgumentTest);
     CPPUNIT_TEST (vga2ansiTest);
     CPPUNIT_TEST (fakeReverseTest);
+    CPPUNIT_TEST (transitionCacheTest);
     CPPUNIT_TEST (ansiTest);
     CPPUNIT_TEST (vt100Test);
     CPPUNIT_TEST (xtermTest);
@@ -246,6 +248,66 @@ void FOptiAttrTest::fakeReverseTest()
   delete from;
 }
 
+//----------------------------------------------------------------------
+void FOptiAttrTest::transitionCacheTest()
+{
+  finalcut::FOptiAttr oa;
+  oa.setDefaultColorSupport();  // ANSI default color
+  oa.setMaxColor (8);
+  oa.set_enter_bold_mode (C_STR(CSI "1m"));
+  oa.set_exit_bold_mode (C_STR(CSI "0m"));
+  oa.set_exit_attribute_mode (C_STR(CSI "0m"));
+  oa.set_a_foreground_color (C_STR(CSI "3%p1%dm"));
+  oa.set_a_background_color (C_STR(CSI "4%p1%dm"));
+  oa.set_orig_pair (C_STR(CSI "39;49m"));
+  oa.initialize();
+  CPPUNIT_ASSERT ( oa.getCacheHits() == 0 );
+  CPPUNIT_ASSERT ( oa.getCacheMisses() == 0 );
+
+  finalcut::FChar* term = new finalcut::FChar();
+  finalcut::FChar* normal = new finalcut::FChar();
+  finalcut::FChar* bold = new finalcut::FChar();
+  term->fg_color = normal->fg_color = bold->fg_color = finalcut::fc::Default;
+  term->bg_color = normal->bg_color = bold->bg_color = finalcut::fc::Default;
+  normal->fg_color = finalcut::fc::White;
+  normal->bg_color = finalcut::fc::Blue;
+  bold->fg_color = finalcut::fc::Red;
+  bold->bg_color = finalcut::fc::Blue;
+  bold->attr.bit.bold = true;
+
+  // The first transitions are generated
+  CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(term, normal)
+                         , C_STR(CSI "37m" CSI "44m") );
+  CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(term, bold)
+                         , C_STR(CSI "31m" CSI "1m") );
+  CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(term, normal)
+                         , C_STR(CSI "0m" CSI "37m" CSI "44m") );
+  CPPUNIT_ASSERT ( oa.changeAttribute(term, normal) == 0 );
+  CPPUNIT_ASSERT ( oa.getCacheHits() == 0 );
+  CPPUNIT_ASSERT ( oa.getCacheMisses() == 4 );
+
+  // Repeated transitions come from the cache
+  CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(term, bold)
+                         , C_STR(CSI "31m" CSI "1m") );
+  CPPUNIT_ASSERT ( *term == *bold );
+  CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(term, normal)
+                         , C_STR(CSI "0m" CSI "37m" CSI "44m") );
+  CPPUNIT_ASSERT ( *term == *normal );
+  CPPUNIT_ASSERT ( oa.changeAttribute(term, normal) == 0 );
+  CPPUNIT_ASSERT ( oa.getCacheHits() == 3 );
+  CPPUNIT_ASSERT ( oa.getCacheMisses() == 4 );
+
+  // New capabilities invalidate the cache
+  oa.setMaxColor (1);
+  CPPUNIT_ASSERT ( oa.changeAttribute(term, bold) != 0 );
+  CPPUNIT_ASSERT ( oa.getCacheHits() == 3 );
+  CPPUNIT_ASSERT ( oa.getCacheMisses() == 5 );
+
+  delete bold;
+  delete normal;
+  delete term;
+}
+
 //----------------------------------------------------------------------
 void FOptiAttrTest::ansiTest()
 {
@@ -934,7 +996,7 @@ void FOptiAttrTest::vt100Test()
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to)
                          , C_STR(CSI "0m\017$<2>") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -1882,7 +1944,7 @@ void FOptiAttrTest::rxvtTest()
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to)
                          , C_STR(CSI "0m\017") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -2354,7 +2416,7 @@ void FOptiAttrTest::linuxTest()
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to)
                          , C_STR(CSI "0m\017") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -2838,7 +2900,7 @@ void FOptiAttrTest::puttyTest()
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to)
                          , C_STR(CSI "0m\017") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -3312,7 +3374,7 @@ void FOptiAttrTest::teratermTest()
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to)
                          , C_STR(CSI "0m\017$<2>") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -3770,7 +3832,7 @@ void FOptiAttrTest::ibmColorTest()
   CPPUNIT_ASSERT ( *from != *to );
   CPPUNIT_ASSERT_CSTRING ( oa.changeAttribute(from, to), C_STR("") );
   CPPUNIT_ASSERT ( *from == *to );
-  CPPUNIT_ASSERT ( to->encoded_char == ' ' );
+  CPPUNIT_ASSERT ( oa.isInvisibleSimulated(to) );
   CPPUNIT_ASSERT ( oa.changeAttribute(from, to) == 0 );
 
   // Invisible off (with default colors)
@@ -31,6 +31,9 @@
 #include <cppunit/SourceLine.h>
 #include <cppunit/TestAssert.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <iomanip>
 #include <string>
 #include <final/final.h>
@@ -67,10 +70,12 @@ class FOptiMoveTest : public CPPUNIT_NS::TestFixture
   protected:
     void classNameTest();
     void noArgumentTest();
+    void invalidCursorAddressTest();
     void homeTest();
     void fromLeftToRightTest();
     void ansiTest();
     void vt100Test();
+    void baudRateTest();
     void xtermTest();
     void rxvtTest();
     void linuxTest();
@@ -78,9 +83,11 @@ class FOptiMoveTest : public CPPUNIT_NS::TestFixture
     void puttyTest();
     void teratermTest();
     void wyse50Test();
+    void xtermGridTest();
 
   private:
     std::string printSequence (const std::string&);
+    bool        followXtermSequence (const char*, int&, int&);
 
     // Adds code needed to register the test suite
     CPPUNIT_TEST_SUITE (FOptiMoveTest);
@@ -88,10 +95,12 @@ class FOptiMoveTest : public CPPUNIT_NS::TestFixture
     // Add a methods to the test suite
     CPPUNIT_TEST (classNameTest);
     CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (invalidCursorAddressTest);
     CPPUNIT_TEST (homeTest);
     CPPUNIT_TEST (fromLeftToRightTest);
     CPPUNIT_TEST (ansiTest);
     CPPUNIT_TEST (vt100Test);
+    CPPUNIT_TEST (baudRateTest);
     CPPUNIT_TEST (xtermTest);
     CPPUNIT_TEST (rxvtTest);
     CPPUNIT_TEST (linuxTest);
@@ -99,6 +108,7 @@ class FOptiMoveTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST (puttyTest);
     CPPUNIT_TEST (teratermTest);
     CPPUNIT_TEST (wyse50Test);
+    CPPUNIT_TEST (xtermGridTest);
 
     // End of test suite definition
     CPPUNIT_TEST_SUITE_END();
@@ -141,6 +151,46 @@ void FOptiMoveTest::noArgumentTest()
   CPPUNIT_ASSERT (om.moveCursor (1, 1, 5, 5) == 0);
 }
 
+//----------------------------------------------------------------------
+void FOptiMoveTest::invalidCursorAddressTest()
+{
+  finalcut::FOptiMove om;
+  om.setTermSize (80, 25);
+  om.set_cursor_home (C_STR(CSI "H"));
+  om.set_carriage_return (C_STR("\r"));
+  om.set_cursor_up (C_STR(CSI "A"));
+  om.set_cursor_down (C_STR("\n"));
+  om.set_cursor_right (C_STR(CSI "C"));
+  om.set_cursor_left (C_STR("\b"));
+  om.set_parm_up_cursor (C_STR(CSI "%p1%dA"));
+  om.set_parm_down_cursor (C_STR(CSI "%p1%dB"));
+  om.set_parm_right_cursor (C_STR(CSI "%p1%dC"));
+  om.set_parm_left_cursor (C_STR(CSI "%p1%dD"));
+
+  // tgoto() cannot expand a third parameter
+  om.set_cursor_address (C_STR(CSI "%i%p1%d;%p3%dH"));
+
+  // The local movement is used instead of an empty string
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (-1, -1, 5, 5)
+                         , C_STR(CSI "H" CSI "5B" CSI "5C"));
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (0, 0, 70, 20)
+                         , C_STR(CSI "20B" CSI "70C"));
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (70, 20, 0, 0), C_STR(CSI "H"));
+
+  // Without any other capability there is no cursor movement
+  om.set_cursor_home (0);
+  om.set_carriage_return (0);
+  om.set_cursor_up (0);
+  om.set_cursor_down (0);
+  om.set_cursor_right (0);
+  om.set_cursor_left (0);
+  om.set_parm_up_cursor (0);
+  om.set_parm_down_cursor (0);
+  om.set_parm_right_cursor (0);
+  om.set_parm_left_cursor (0);
+  CPPUNIT_ASSERT (om.moveCursor (1, 1, 5, 5) == 0);
+}
+
 //----------------------------------------------------------------------
 void FOptiMoveTest::homeTest()
 {
@@ -305,6 +355,27 @@ void FOptiMoveTest::vt100Test()
   CPPUNIT_ASSERT_CSTRING (om.moveCursor (53, 2, 53, -3), C_STR(CSI "2A"));
 }
 
+//----------------------------------------------------------------------
+void FOptiMoveTest::baudRateTest()
+{
+  finalcut::FOptiMove om;
+  om.setTermSize (80, 24);
+  om.setBaudRate (1200);
+  om.set_cursor_up (C_STR(CSI "A$<2>"));
+  om.set_cursor_address (C_STR(CSI "%i%p1%d;%p2%dH$<5>"));
+  om.set_parm_up_cursor (C_STR(CSI "%p1%dA"));
+  CPPUNIT_ASSERT ( om.getBaudRate() == 1200 );
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (16, 1, 16, 0), C_STR(CSI "A$<2>"));
+
+  // At a higher baud rate, the padding time is more expensive
+  om.setBaudRate (115200);
+  CPPUNIT_ASSERT ( om.getBaudRate() == 115200 );
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (16, 1, 16, 0), C_STR(CSI "1A"));
+
+  om.setBaudRate (1200);
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (16, 1, 16, 0), C_STR(CSI "A$<2>"));
+}
+
 //----------------------------------------------------------------------
 void FOptiMoveTest::xtermTest()
 {
@@ -730,6 +801,56 @@ void FOptiMoveTest::wyse50Test()
   CPPUNIT_ASSERT_CSTRING (om.moveCursor (53, 2, 53, -3), C_STR("\v\v"));
 }
 
+//----------------------------------------------------------------------
+void FOptiMoveTest::xtermGridTest()
+{
+  // Every cursor movement on the screen must reach the new position
+  // and must not cost more than the direct cursor addressing
+
+  finalcut::FOptiMove om;
+  om.setTermSize (80, 25);
+  om.setBaudRate (38400);
+  om.setTabStop (8);
+  om.set_eat_newline_glitch (true);
+  om.set_tabular (C_STR("\t"));
+  om.set_back_tab (C_STR(CSI "Z"));
+  om.set_cursor_home (C_STR(CSI "H"));
+  om.set_carriage_return (C_STR("\r"));
+  om.set_cursor_up (C_STR(CSI "A"));
+  om.set_cursor_down (C_STR("\n"));
+  om.set_cursor_right (C_STR(CSI "C"));
+  om.set_cursor_left (C_STR("\b"));
+  om.set_cursor_address (C_STR(CSI "%i%p1%d;%p2%dH"));
+  om.set_column_address (C_STR(CSI "%i%p1%dG"));
+  om.set_row_address (C_STR(CSI "%i%p1%dd"));
+  om.set_parm_up_cursor (C_STR(CSI "%p1%dA"));
+  om.set_parm_down_cursor (C_STR(CSI "%p1%dB"));
+  om.set_parm_right_cursor (C_STR(CSI "%p1%dC"));
+  om.set_parm_left_cursor (C_STR(CSI "%p1%dD"));
+
+  // FOptiMove estimates the cost of the direct cursor addressing
+  // with the sequence for row 24 and column 24
+  const std::size_t direct_length = std::strlen(CSI "24;24H");
+
+  for (int yold{0}; yold < 25; yold++)
+    for (int xold{0}; xold < 80; xold++)
+      for (int ynew{0}; ynew < 25; ynew++)
+        for (int xnew{0}; xnew < 80; xnew++)
+        {
+          const char* move = om.moveCursor (xold, yold, xnew, ynew);
+          CPPUNIT_ASSERT ( move != 0 );
+          CPPUNIT_ASSERT ( std::strlen(move) <= direct_length );
+          int x{xold};
+          int y{yold};
+          CPPUNIT_ASSERT ( followXtermSequence(move, x, y) );
+          CPPUNIT_ASSERT ( x == xnew );
+          CPPUNIT_ASSERT ( y == ynew );
+        }
+
+  // From an unknown position only the direct cursor addressing is used
+  CPPUNIT_ASSERT_CSTRING (om.moveCursor (-1, -1, 79, 24), C_STR(CSI "25;80H"));
+}
+
 //----------------------------------------------------------------------
 std::string FOptiMoveTest::printSequence (const std::string& s)
 {
@@ -758,6 +879,69 @@ std::string FOptiMoveTest::printSequence (const std::string& s)
   return sequence;
 }
 
+//----------------------------------------------------------------------
+bool FOptiMoveTest::followXtermSequence (const char* s, int& x, int& y)
+{
+  // Moves x and y like an 80x25 xterm that receives the sequence s.
+  // Returns false if s contains an unexpected character.
+
+  while ( *s )
+  {
+    if ( *s == '\r' )
+      x = 0;
+    else if ( *s == '\n' )
+      y++;
+    else if ( *s == '\b' )
+      x = std::max(x - 1, 0);
+    else if ( *s == '\t' )
+      x = std::min((x / 8 + 1) * 8, 79);
+    else if ( s[0] == '\033' && s[1] == '[' )
+    {
+      int param[2]{0, 0};
+      int n{0};
+      s += 2;
+
+      while ( std::isdigit(*s) || *s == ';' )
+      {
+        if ( *s == ';' )
+        {
+          if ( ++n > 1 )
+            return false;
+        }
+        else
+          param[n] = param[n] * 10 + (*s - '0');
+
+        s++;
+      }
+
+      const int p1 = std::max(param[0], 1);
+      const int p2 = std::max(param[1], 1);
+
+      switch ( *s )
+      {
+        case 'A': y -= p1; break;
+        case 'B': y += p1; break;
+        case 'C': x += p1; break;
+        case 'D': x -= p1; break;
+        case 'G': x = p1 - 1; break;
+        case 'd': y = p1 - 1; break;
+        case 'H': y = p1 - 1; x = p2 - 1; break;
+        case 'Z': x = std::max((x - 1) / 8 * 8, 0); break;
+        default: return false;
+      }
+    }
+    else
+      return false;
+
+    if ( x < 0 || x > 79 || y < 0 || y > 24 )
+      return false;
+
+    s++;
+  }
+
+  return true;
+}
+
 // Put the test suite in the registry
 CPPUNIT_TEST_SUITE_REGISTRATION (FOptiMoveTest);
 
@@ -0,0 +1,422 @@
+/***********************************************************************
+* foutputwriter-test.cpp - FOutputWriter unit tests                    *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+// class FSystemTest
+//----------------------------------------------------------------------
+
+class FSystemTest : public finalcut::FSystem
+{
+  public:
+    // Constructor
+    FSystemTest() = default;
+
+    // Destructor
+    virtual ~FSystemTest() = default;
+
+    // Methods
+    uChar            inPortByte (uShort) override
+    { return 0; }
+    void             outPortByte (uChar, uShort) override
+    { }
+    int              isTTY (int) override
+    { return 1; }
+    int              ioctl (int, uLong, ...) override
+    { return 0; }
+    int              open (const char*, int, ...) override
+    { return -1; }
+    int              close (int) override
+    { return 0; }
+    FILE*            fopen (const char*, const char*) override
+    { return nullptr; }
+    int              fclose (FILE*) override
+    { return 0; }
+    int              putchar (int c) override
+    { return c; }
+    ssize_t          write (int, const void*, std::size_t) override;
+    int              poll (struct pollfd*, nfds_t, int) override;
+    int              tputs (const char*, int, int (*)(int)) override
+    { return 0; }
+    uid_t            getuid() override
+    { return 0; }
+    uid_t            geteuid() override
+    { return 0; }
+    int              getpwuid_r ( uid_t, struct passwd*, char*
+                                , size_t, struct passwd** ) override
+    { return 0; }
+    char*            realpath (const char*, char*) override
+    { return nullptr; }
+    std::string&     getCharacters();
+    int              getWriteCalls();
+    int              getWriteAttempts();
+    int              getPollCalls();
+    short            getPollEvents();
+    std::mutex&      getOutputLock();
+    void             setFileOutput (bool);
+    void             setWouldBlock (int);
+
+  private:
+    // Data members
+    std::string characters{};
+    int write_calls{0};
+    std::atomic<int> write_attempts{0};
+    int poll_calls{0};
+    short poll_events{0};
+    int would_block{0};        // Number of write() calls with EAGAIN
+    std::mutex output_lock{};  // Holding it blocks the output
+    bool file_output{false};   // Writes to the real file descriptor
+};
+
+//----------------------------------------------------------------------
+ssize_t FSystemTest::write (int fd, const void* buf, std::size_t n)
+{
+  write_attempts++;
+
+  if ( file_output )
+    return ::write (fd, buf, n);
+
+  if ( would_block > 0 )
+  {
+    would_block--;
+    errno = EAGAIN;
+    return -1;
+  }
+
+  std::lock_guard<std::mutex> lock(output_lock);
+  characters.append (static_cast<const char*>(buf), n);
+  write_calls++;
+  return ssize_t(n);
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::poll (struct pollfd* fds, nfds_t nfds, int timeout)
+{
+  if ( file_output )
+    return ::poll (fds, nfds, timeout);
+
+  poll_calls++;
+  poll_events = fds[0].events;
+  fds[0].revents = POLLOUT;
+  return 1;
+}
+
+//----------------------------------------------------------------------
+std::string& FSystemTest::getCharacters()
+{
+  return characters;
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::getWriteCalls()
+{
+  return write_calls;
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::getWriteAttempts()
+{
+  return write_attempts;
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::getPollCalls()
+{
+  return poll_calls;
+}
+
+//----------------------------------------------------------------------
+short FSystemTest::getPollEvents()
+{
+  return poll_events;
+}
+
+//----------------------------------------------------------------------
+std::mutex& FSystemTest::getOutputLock()
+{
+  return output_lock;
+}
+
+//----------------------------------------------------------------------
+void FSystemTest::setFileOutput (bool enable)
+{
+  file_output = enable;
+}
+
+//----------------------------------------------------------------------
+void FSystemTest::setWouldBlock (int n)
+{
+  would_block = n;
+}
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FOutputWriterTest
+//----------------------------------------------------------------------
+
+class FOutputWriterTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FOutputWriterTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void writeTest();
+    void mergeTest();
+    void stopTest();
+    void nonBlockingTest();
+    void wouldBlockTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FOutputWriterTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (writeTest);
+    CPPUNIT_TEST (mergeTest);
+    CPPUNIT_TEST (stopTest);
+    CPPUNIT_TEST (nonBlockingTest);
+    CPPUNIT_TEST (wouldBlockTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::classNameTest()
+{
+  const finalcut::FOutputWriter w;
+  const finalcut::FString& classname = w.getClassName();
+  CPPUNIT_ASSERT ( classname == "FOutputWriter" );
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::noArgumentTest()
+{
+  finalcut::FOutputWriter w;
+  CPPUNIT_ASSERT ( ! w.isRunning() );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 0 );
+  CPPUNIT_ASSERT ( w.getMergedFrames() == 0 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 0 );
+  CPPUNIT_ASSERT ( w.getWriteStallTime() == 0 );
+  CPPUNIT_ASSERT ( w.getMaxWriteStallTime() == 0 );
+
+  // Without a system object the writer does not start
+  w.start (nullptr, 1);
+  CPPUNIT_ASSERT ( ! w.isRunning() );
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::writeTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FOutputWriter w;
+  w.start (&fsystem, 1);
+  CPPUNIT_ASSERT ( w.isRunning() );
+
+  std::string buffer{"\033[H\033[2JFrame 1"};
+  w.write (buffer);
+  CPPUNIT_ASSERT ( buffer.empty() );
+  w.waitForCompletion();
+  CPPUNIT_ASSERT ( fsystem.getCharacters() == "\033[H\033[2JFrame 1" );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 1 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 14 );
+
+  buffer = "\033[1;7H2";
+  w.write (buffer);
+  w.waitForCompletion();
+  CPPUNIT_ASSERT ( fsystem.getCharacters() == "\033[H\033[2JFrame 1\033[1;7H2" );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 2 );
+  CPPUNIT_ASSERT ( w.getMergedFrames() == 0 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 21 );
+  CPPUNIT_ASSERT ( w.getMaxWriteStallTime() <= w.getWriteStallTime() );
+
+  // An empty buffer only flushes the stdio stream
+  buffer.clear();
+  w.write (buffer);
+  w.waitForCompletion();
+  CPPUNIT_ASSERT ( w.getFrameCount() == 2 );
+  CPPUNIT_ASSERT ( fsystem.getWriteCalls() == 2 );
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::mergeTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FOutputWriter w;
+  w.start (&fsystem, 1);
+  std::string buffer{};
+
+  {
+    // Blocks the terminal output
+    std::lock_guard<std::mutex> lock(fsystem.getOutputLock());
+    buffer = "A";
+    w.write (buffer);
+
+    // Waits until the writer thread hangs in write()
+    while ( fsystem.getWriteAttempts() == 0 )
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // The two following frames are merged into one
+    buffer = "B";
+    w.write (buffer);
+    buffer = "C";
+    w.write (buffer);
+  }
+
+  w.waitForCompletion();
+  CPPUNIT_ASSERT ( fsystem.getCharacters() == "ABC" );
+  CPPUNIT_ASSERT ( fsystem.getWriteCalls() == 2 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 3 );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 2 );
+  CPPUNIT_ASSERT ( w.getMergedFrames() == 1 );
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::stopTest()
+{
+  test::FSystemTest fsystem;
+  finalcut::FOutputWriter w;
+  w.start (&fsystem, 1);
+  std::string buffer{};
+
+  for (int i{0}; i < 100; i++)
+  {
+    buffer = std::to_string(i % 10);
+    w.write (buffer);
+  }
+
+  // Stopping writes the remaining output
+  w.stop();
+  CPPUNIT_ASSERT ( ! w.isRunning() );
+  CPPUNIT_ASSERT ( fsystem.getCharacters().length() == 100 );
+  CPPUNIT_ASSERT ( fsystem.getCharacters().substr(0, 10) == "0123456789" );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 100 );
+  CPPUNIT_ASSERT ( w.getFrameCount() + w.getMergedFrames() == 100 );
+
+  // Output after the stop is not written
+  buffer = "X";
+  w.write (buffer);
+  w.stop();
+  CPPUNIT_ASSERT ( fsystem.getCharacters().length() == 100 );
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::nonBlockingTest()
+{
+  test::FSystemTest fsystem;
+  fsystem.setFileOutput(true);
+  int fds[2];
+  CPPUNIT_ASSERT ( pipe(fds) == 0 );
+  CPPUNIT_ASSERT ( fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0 );
+
+  // Fills the pipe until a write would block
+  const std::string chunk(4096, '.');
+
+  while ( ::write(fds[1], chunk.data(), chunk.length()) > 0 ) ;
+
+  finalcut::FOutputWriter w;
+  w.start (&fsystem, fds[1]);
+  std::string buffer{"Frame"};
+  w.write (buffer);
+
+  // The writer waits for the pipe instead of retrying write()
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  const int write_attempts = fsystem.getWriteAttempts();
+  const auto frames_before_read = w.getFrameCount();
+
+  // Reading from the pipe lets the frame through
+  std::string received{};
+  char read_buf[4096];
+  ssize_t bytes{};
+
+  while ( received.find("Frame") == std::string::npos
+       && (bytes = ::read(fds[0], read_buf, sizeof(read_buf))) > 0 )
+    received.append (read_buf, std::size_t(bytes));
+
+  w.waitForCompletion();
+  CPPUNIT_ASSERT ( write_attempts <= 2 );
+  CPPUNIT_ASSERT ( frames_before_read == 0 );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 1 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 5 );
+  w.stop();
+  close (fds[0]);
+  close (fds[1]);
+}
+
+//----------------------------------------------------------------------
+void FOutputWriterTest::wouldBlockTest()
+{
+  test::FSystemTest fsystem;
+  fsystem.setWouldBlock(1);
+  finalcut::FOutputWriter w;
+  w.start (&fsystem, 1);
+  std::string buffer{"Frame"};
+  w.write (buffer);
+  w.waitForCompletion();
+
+  // The writer waits for POLLOUT and then repeats the write()
+  CPPUNIT_ASSERT ( fsystem.getPollCalls() == 1 );
+  CPPUNIT_ASSERT ( fsystem.getPollEvents() == POLLOUT );
+  CPPUNIT_ASSERT ( fsystem.getWriteAttempts() == 2 );
+  CPPUNIT_ASSERT ( fsystem.getWriteCalls() == 1 );
+  CPPUNIT_ASSERT ( fsystem.getCharacters() == "Frame" );
+  CPPUNIT_ASSERT ( w.getFrameCount() == 1 );
+  CPPUNIT_ASSERT ( w.getWrittenBytes() == 5 );
+  w.stop();
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FOutputWriterTest);
+
+// The general unit test main part
+#include <main-test.inc>
@@ -0,0 +1,266 @@
+/***********************************************************************
+* ftaskregistry-test.cpp - FTaskRegistry unit tests                    *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+// class PostedTasks
+//----------------------------------------------------------------------
+
+class PostedTasks
+{
+  public:
+    // Typedef
+    typedef finalcut::FTaskRegistry::FTask FTask;
+
+    // Accessor
+    finalcut::FTaskRegistry::FPostFunction getPostFunction()
+    {
+      return [this] (const finalcut::FObject* receiver, const FTask& done)
+             {
+               std::lock_guard<std::mutex> lock(mutex);
+               posted.emplace_back(receiver, done);
+             };
+    }
+
+    // Methods
+    std::size_t count()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      return posted.size();
+    }
+
+    const finalcut::FObject* getReceiver (std::size_t n)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      return posted[n].first;
+    }
+
+    void call (std::size_t n)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      posted[n].second();
+    }
+
+  private:
+    // Data members
+    std::mutex mutex{};
+    std::vector<std::pair<const finalcut::FObject*, FTask> > posted{};
+};
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FTaskRegistryTest
+//----------------------------------------------------------------------
+
+class FTaskRegistryTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FTaskRegistryTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void continuationTest();
+    void cancelTest();
+    void deletedReceiverTest();
+    void stoppedPoolTest();
+
+  private:
+    // Methods
+    static void wait (const std::atomic<bool>&);
+
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FTaskRegistryTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (continuationTest);
+    CPPUNIT_TEST (cancelTest);
+    CPPUNIT_TEST (deletedReceiverTest);
+    CPPUNIT_TEST (stoppedPoolTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::classNameTest()
+{
+  const finalcut::FTaskRegistry registry;
+  const finalcut::FString& classname = registry.getClassName();
+  CPPUNIT_ASSERT ( classname == "FTaskRegistry" );
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::continuationTest()
+{
+  finalcut::FWorkerPool pool(2);
+  finalcut::FObject receiver;
+  test::PostedTasks posted;
+  std::atomic<int> result{0};
+  bool done_called{false};
+
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::submit
+  (
+    pool, &receiver
+    , [&result] () { result = 42; }
+    , [&result, &done_called] ()
+      {
+        done_called = true;
+        CPPUNIT_ASSERT ( result == 42 );
+      }
+    , posted.getPostFunction()
+  ) );
+
+  pool.waitForIdle();
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver) == 0 );
+  CPPUNIT_ASSERT ( posted.count() == 1 );
+  CPPUNIT_ASSERT ( posted.getReceiver(0) == &receiver );
+
+  // The continuation is called by the consumer of the posted tasks
+  CPPUNIT_ASSERT ( ! done_called );
+  posted.call(0);
+  CPPUNIT_ASSERT ( done_called );
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::cancelTest()
+{
+  finalcut::FWorkerPool pool(2);
+  finalcut::FObject receiver1;
+  finalcut::FObject receiver2;
+  test::PostedTasks posted;
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  auto task = [&started, &release] ()
+              {
+                started = true;
+                wait (release);
+              };
+
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::submit
+                     ( pool, &receiver1, task, [] () { }
+                     , posted.getPostFunction() ) );
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::submit
+                     ( pool, &receiver1, task, [] () { }
+                     , posted.getPostFunction() ) );
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::submit
+                     ( pool, &receiver2, task, [] () { }
+                     , posted.getPostFunction() ) );
+  wait (started);
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver1) == 2 );
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver2) == 1 );
+
+  // Only the continuations of receiver1 are dropped
+  finalcut::FTaskRegistry::cancel (&receiver1);
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver1) == 0 );
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver2) == 1 );
+  release = true;
+  pool.waitForIdle();
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver2) == 0 );
+  CPPUNIT_ASSERT ( posted.count() == 1 );
+  CPPUNIT_ASSERT ( posted.getReceiver(0) == &receiver2 );
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::deletedReceiverTest()
+{
+  // A receiver that is not a widget is destroyed while its task runs
+  finalcut::FWorkerPool pool(1);
+  test::PostedTasks posted;
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  bool done_called{false};
+  auto receiver = new finalcut::FObject();
+
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::submit
+  (
+    pool, receiver
+    , [&started, &release] ()
+      {
+        started = true;
+        wait (release);
+      }
+    , [&done_called] () { done_called = true; }
+    , posted.getPostFunction()
+  ) );
+
+  wait (started);
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(receiver) == 1 );
+
+  // The destructor of FObject cancels the continuation
+  delete receiver;
+  release = true;
+  pool.waitForIdle();
+  CPPUNIT_ASSERT ( posted.count() == 0 );
+  CPPUNIT_ASSERT ( ! done_called );
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::stoppedPoolTest()
+{
+  finalcut::FWorkerPool pool(1);
+  finalcut::FObject receiver;
+  test::PostedTasks posted;
+  pool.stop();
+
+  CPPUNIT_ASSERT ( ! finalcut::FTaskRegistry::submit
+                       ( pool, &receiver, [] () { }, [] () { }
+                       , posted.getPostFunction() ) );
+  CPPUNIT_ASSERT ( finalcut::FTaskRegistry::getTaskCount(&receiver) == 0 );
+  CPPUNIT_ASSERT ( posted.count() == 0 );
+}
+
+//----------------------------------------------------------------------
+void FTaskRegistryTest::wait (const std::atomic<bool>& flag)
+{
+  while ( ! flag )
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FTaskRegistryTest);
+
+// The general unit test main part
+#include <main-test.inc>
@@ -0,0 +1,235 @@
+/***********************************************************************
+* fterm_functions-test.cpp - FTerm non-member function unit tests      *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+
+//----------------------------------------------------------------------
+// class FTermFunctionsTest
+//----------------------------------------------------------------------
+
+class FTermFunctionsTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FTermFunctionsTest()
+    { }
+
+  protected:
+    void characterIndexTest();
+    void cp437Test();
+    void charEncodeTest();
+    void columnWidthTest();
+    void stringColumnWidthTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FTermFunctionsTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (characterIndexTest);
+    CPPUNIT_TEST (cp437Test);
+    CPPUNIT_TEST (charEncodeTest);
+    CPPUNIT_TEST (columnWidthTest);
+    CPPUNIT_TEST (stringColumnWidthTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FTermFunctionsTest::characterIndexTest()
+{
+  // Every character in fc::character finds its own line
+  for (std::size_t i{0}; i <= finalcut::fc::lastCharItem; i++)
+  {
+    const auto ucs = wchar_t(finalcut::fc::character[i][finalcut::fc::UTF8]);
+    const int index = finalcut::getCharacterIndex(ucs);
+    CPPUNIT_ASSERT ( index >= 0 );
+    CPPUNIT_ASSERT ( index <= int(i) );
+    CPPUNIT_ASSERT ( finalcut::fc::character[index][finalcut::fc::UTF8]
+                     == uInt(ucs) );
+  }
+
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(0x20ac) == 0 );  // €
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(0x00a3) == 1 );  // £
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(L'A') == -1 );
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(0x4e00) == -1 );
+
+  // Outside the basic multilingual plane
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(0x1f600) == -1 );
+  CPPUNIT_ASSERT ( finalcut::getCharacterIndex(0x110000) == -1 );
+}
+
+//----------------------------------------------------------------------
+void FTermFunctionsTest::cp437Test()
+{
+  // Round trip for all CP437 characters
+  for (uInt c{0}; c <= 0xff; c++)
+  {
+    const wchar_t ucs = finalcut::cp437_to_unicode(uChar(c));
+    CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(ucs) == uChar(c) );
+  }
+
+  CPPUNIT_ASSERT ( finalcut::cp437_to_unicode(0x01) == 0x263a );  // ☺
+  CPPUNIT_ASSERT ( finalcut::cp437_to_unicode('A') == L'A' );
+  CPPUNIT_ASSERT ( finalcut::cp437_to_unicode(0xdb) == 0x2588 );  // █
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(0x263a) == 0x01 );
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(L'A') == 'A' );
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(0x2588) == 0xdb );
+
+  // Characters without a CP437 equivalent
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(0x4e00) == '?' );
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(0x1f600) == '?' );
+  CPPUNIT_ASSERT ( finalcut::unicode_to_cp437(0x110000) == '?' );
+}
+
+//----------------------------------------------------------------------
+void FTermFunctionsTest::charEncodeTest()
+{
+  using finalcut::FTerm;
+  using finalcut::fc::VT100;
+  using finalcut::fc::PC;
+
+  // VT100 line graphics
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x2592, VT100) == L'a' );  // ▒
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x2588, VT100) == L'0' );  // █
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x00a3, VT100) == L'}' );  // £
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x03c0, VT100) == L'{' );  // π
+
+  // Characters outside fc::character stay unchanged
+  CPPUNIT_ASSERT ( FTerm::charEncode(L'A', VT100) == L'A' );
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x4e00, VT100) == 0x4e00 );
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x1f600, VT100) == 0x1f600 );
+
+  // PC encoding (IBM-437)
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x20ac, PC) == 0xee );  // €
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x2592, PC) == 0xb0 );  // ▒
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x2588, PC) == 0xdb );  // █
+  CPPUNIT_ASSERT ( FTerm::charEncode(L'A', PC) == L'A' );
+
+  // Not in fc::character, but in the CP437 table
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x263a, PC) == 0x01 );  // ☺
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x2663, PC) == 0x05 );  // ♣
+
+  // No CP437 equivalent
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x4e00, PC) == L'?' );
+  CPPUNIT_ASSERT ( FTerm::charEncode(0x1f600, PC) == L'?' );
+}
+
+//----------------------------------------------------------------------
+void FTermFunctionsTest::columnWidthTest()
+{
+  // The widths do not depend on the locale
+  // (checked against wcwidth() of glibc 2.36)
+  using finalcut::getColumnWidth;
+
+  // Printable ASCII characters
+  CPPUNIT_ASSERT ( getColumnWidth(L' ') == 1 );
+  CPPUNIT_ASSERT ( getColumnWidth(L'A') == 1 );
+  CPPUNIT_ASSERT ( getColumnWidth(L'~') == 1 );
+
+  // Control characters
+  CPPUNIT_ASSERT ( getColumnWidth(L'\0') == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(L'\t') == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x1b)) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x7f)) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x9b)) == 0 );
+
+  // Latin-1 and other narrow characters
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x00e4)) == 1 );  // ä
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x03c0)) == 1 );  // π
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x2588)) == 1 );  // █
+
+  // Combining characters
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x0301)) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x20d7)) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x200b)) == 0 );  // Zero width space
+
+  // Wide characters
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x1100)) == 2 );  // Hangul ᄀ
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x3042)) == 2 );  // あ
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x4e00)) == 2 );  // 一
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0xff21)) == 2 );  // Ａ
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x1f600)) == 2 );  // 😀
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x20000)) == 2 );
+
+  // Unassigned code points are narrow
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x0378)) == 1 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x10ffff)) == 1 );
+
+  // Code points above U+10FFFF have no width
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x110000)) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(wchar_t(0x7fffffff)) == 0 );
+}
+
+//----------------------------------------------------------------------
+void FTermFunctionsTest::stringColumnWidthTest()
+{
+  using finalcut::FString;
+  using finalcut::getColumnWidth;
+
+  CPPUNIT_ASSERT ( getColumnWidth(FString()) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString("")) == 0 );
+
+  // ASCII runs below, at and above the group size of eight characters
+  CPPUNIT_ASSERT ( getColumnWidth(FString("1234567")) == 7 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString("12345678")) == 8 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString("123456789")) == 9 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString("1234567890123456")) == 16 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString("12345678901234567")) == 17 );
+
+  // A non-ASCII character inside a group of eight
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"123\x4e00" L"5678")) == 9 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"1234567\x4e00")) == 9 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"e\x0301\x0301") + "12345") == 6 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"1234\t678")) == 7 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"\x1f600\x1f600\x1f600\x1f600"
+                                          L"\x1f600\x1f600\x1f600\x1f600"
+                                          L"\x1f600")) == 18 );
+
+  // A non-ASCII character after the last full group
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"12345678\x4e00")) == 10 );
+  CPPUNIT_ASSERT ( getColumnWidth(FString(L"12345678\x0301")) == 8 );
+
+  // Column width of the first characters
+  const FString s{L"1234567\x4e00\x4e00"};
+  CPPUNIT_ASSERT ( getColumnWidth(s, 0) == 0 );
+  CPPUNIT_ASSERT ( getColumnWidth(s, 7) == 7 );
+  CPPUNIT_ASSERT ( getColumnWidth(s, 8) == 9 );
+  CPPUNIT_ASSERT ( getColumnWidth(s, 9) == 11 );
+  CPPUNIT_ASSERT ( getColumnWidth(s, 100) == 11 );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FTermFunctionsTest);
+
+// The general unit test main part
+#include <main-test.inc>
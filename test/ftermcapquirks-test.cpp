@@ -144,6 +144,7 @@ static tcap_map tcap[] =
   { 0, "ks" },  // keypad_xmit
   { 0, "ke" },  // keypad_local
   { 0, "Km" },  // key_mouse
+  { 0, "cs" },  // change_scroll_region
   { 0, "\0" }
 };
 
@@ -180,6 +180,7 @@ void FTermDetectionTest::ansiTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( ! detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
     CPPUNIT_ASSERT_CSTRING ( detect.getTermType(), C_STR("ansi") );
 
     // Test fallback to vt100 without TERM environment variable
@@ -249,6 +250,7 @@ void FTermDetectionTest::xtermTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -310,6 +312,7 @@ void FTermDetectionTest::rxvtTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
     CPPUNIT_ASSERT_CSTRING ( detect.getTermType(), C_STR("rxvt-cygwin-native") );
 
     printConEmuDebug();
@@ -372,6 +375,7 @@ void FTermDetectionTest::urxvtTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -434,6 +438,7 @@ void FTermDetectionTest::mltermTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
     CPPUNIT_ASSERT_CSTRING ( detect.getTermType(), C_STR("mlterm-256color") );
 
     setenv ("TERM", "mlterm", 1);
@@ -502,6 +507,7 @@ void FTermDetectionTest::puttyTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     enableConEmuDebug(true);
     printConEmuDebug();
@@ -564,6 +570,7 @@ void FTermDetectionTest::kdeKonsoleTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -626,6 +633,7 @@ void FTermDetectionTest::gnomeTerminalTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -688,6 +696,7 @@ void FTermDetectionTest::newerVteTerminalTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -750,6 +759,7 @@ void FTermDetectionTest::ktermTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( ! detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -819,6 +829,7 @@ void FTermDetectionTest::teraTermTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -881,6 +892,7 @@ void FTermDetectionTest::cygwinTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -943,6 +955,7 @@ void FTermDetectionTest::minttyTest()
     CPPUNIT_ASSERT ( detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( detect.hasSynchronizedOutputSupport() );
 
     printConEmuDebug();
     closeConEmuStdStreams();
@@ -1005,6 +1018,7 @@ void FTermDetectionTest::linuxTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -1075,6 +1089,7 @@ void FTermDetectionTest::freebsdTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -1147,6 +1162,7 @@ void FTermDetectionTest::netbsdTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -1217,6 +1233,7 @@ void FTermDetectionTest::openbsdTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -1285,6 +1302,7 @@ void FTermDetectionTest::sunTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( ! detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
 
     // Test fallback to vt100 without TERM environment variable
     unsetenv("TERM");
@@ -1354,6 +1372,7 @@ void FTermDetectionTest::screenTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
     CPPUNIT_ASSERT_CSTRING ( detect.getTermType(), C_STR("screen") );
 
     setenv ("XTERM_VERSION", "XTerm(312)", 1);
@@ -1423,6 +1442,7 @@ void FTermDetectionTest::tmuxTest()
     CPPUNIT_ASSERT ( ! detect.canDisplay256Colors() );
     CPPUNIT_ASSERT ( detect.hasTerminalDetection() );
     CPPUNIT_ASSERT ( ! detect.hasSetCursorStyleSupport() );
+    CPPUNIT_ASSERT ( ! detect.hasSynchronizedOutputSupport() );
     CPPUNIT_ASSERT_CSTRING ( detect.getTermType(), C_STR("screen") );
 
     setenv ("VTE_VERSION", "3801", 1);
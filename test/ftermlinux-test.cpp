@@ -111,6 +111,8 @@ class FSystemTest : public finalcut::FSystem
     FILE*            fopen (const char*, const char*) override;
     int              fclose (FILE*) override;
     int              putchar (int) override;
+    ssize_t          write (int, const void*, std::size_t) override;
+    int              poll (struct pollfd*, nfds_t, int) override;
     int              tputs (const char*, int, int (*)(int)) override;
     uid_t            getuid() override;
     uid_t            geteuid() override;
@@ -1336,6 +1338,23 @@ int FSystemTest::putchar (int c)
   return 1;
 }
 
+//----------------------------------------------------------------------
+ssize_t FSystemTest::write (int fd, const void* buf, std::size_t count)
+{
+  std::cerr << "Call: write (fd=" << fd << ", buf=" << buf
+            << ", count=" << count << ")\n";
+  characters.append(static_cast<const char*>(buf), count);
+  return ssize_t(count);
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::poll (struct pollfd* fds, nfds_t nfds, int timeout)
+{
+  std::cerr << "Call: poll (fds=" << fds << ", nfds=" << nfds
+            << ", timeout=" << timeout << ")\n";
+  return int(nfds);
+}
+
 //----------------------------------------------------------------------
 int FSystemTest::tputs (const char* str, int affcnt, int (*putc)(int))
 {
@@ -79,6 +79,8 @@ class FSystemTest : public finalcut::FSystem
     FILE*            fopen (const char*, const char*) override;
     int              fclose (FILE*) override;
     int              putchar (int) override;
+    ssize_t          write (int, const void*, std::size_t) override;
+    int              poll (struct pollfd*, nfds_t, int) override;
     int              tputs (const char*, int, int (*)(int)) override;
     uid_t            getuid() override;
     uid_t            geteuid() override;
@@ -262,6 +264,18 @@ int FSystemTest::putchar (int c)
 #endif
 }
 
+//----------------------------------------------------------------------
+ssize_t FSystemTest::write (int fd, const void* buf, std::size_t count)
+{
+  return ::write (fd, buf, count);
+}
+
+//----------------------------------------------------------------------
+int FSystemTest::poll (struct pollfd* fds, nfds_t nfds, int timeout)
+{
+  return ::poll (fds, nfds, timeout);
+}
+
 //----------------------------------------------------------------------
 int FSystemTest::tputs (const char* str, int affcnt, int (*putc)(int))
 {
@@ -0,0 +1,253 @@
+/***********************************************************************
+* ftimerheap-test.cpp - FTimerHeap unit tests                          *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+timeval ms (long msec)
+{
+  timeval t{};
+  t.tv_sec = msec / 1000;
+  t.tv_usec = (msec % 1000) * 1000;
+  return t;
+}
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FTimerHeapTest
+//----------------------------------------------------------------------
+
+class FTimerHeapTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FTimerHeapTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void orderTest();
+    void eraseTest();
+    void objectTest();
+    void rescheduleTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FTimerHeapTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (orderTest);
+    CPPUNIT_TEST (eraseTest);
+    CPPUNIT_TEST (objectTest);
+    CPPUNIT_TEST (rescheduleTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::classNameTest()
+{
+  const finalcut::FTimerHeap h;
+  const finalcut::FString& classname = h.getClassName();
+  CPPUNIT_ASSERT ( classname == "FTimerHeap" );
+}
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::noArgumentTest()
+{
+  finalcut::FTimerHeap h;
+  CPPUNIT_ASSERT ( h.empty() );
+  CPPUNIT_ASSERT ( h.size() == 0 );
+  CPPUNIT_ASSERT ( h.find(1) == nullptr );
+  CPPUNIT_ASSERT ( h.find(0) == nullptr );
+  CPPUNIT_ASSERT ( h.find(-1) == nullptr );
+  CPPUNIT_ASSERT ( h.count(nullptr) == 0 );
+  CPPUNIT_ASSERT ( ! h.erase(1) );
+  CPPUNIT_ASSERT ( ! h.erase(nullptr) );
+
+  // No effect on an empty heap
+  h.pop();
+  h.reschedule (test::ms(10));
+  CPPUNIT_ASSERT ( h.empty() );
+}
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::orderTest()
+{
+  finalcut::FObject obj;
+  finalcut::FTimerHeap h;
+  const long timeouts[] = { 500, 100, 900, 300, 700, 100, 800, 200 };
+
+  for (long t : timeouts)
+    h.insert (&obj, test::ms(t), test::ms(t));
+
+  CPPUNIT_ASSERT ( h.size() == 8 );
+  CPPUNIT_ASSERT ( h.find(1)->timeout.tv_usec == 500000 );
+  CPPUNIT_ASSERT ( h.find(8)->timeout.tv_usec == 200000 );
+
+  // Timers leave the queue sorted by timeout, equal
+  // timeouts in the order in which they were inserted
+  const int ids[] = { 2, 6, 8, 4, 1, 5, 7, 3 };
+
+  for (int id : ids)
+  {
+    CPPUNIT_ASSERT ( h.top().id == id );
+    h.pop();
+  }
+
+  CPPUNIT_ASSERT ( h.empty() );
+  CPPUNIT_ASSERT ( h.count(&obj) == 0 );
+
+  // Many timers
+  for (long i{0}; i < 1000; i++)
+    h.insert (&obj, test::ms(0), test::ms((i * 7919) % 1000));
+
+  CPPUNIT_ASSERT ( h.size() == 1000 );
+  timeval last{};
+
+  while ( ! h.empty() )
+  {
+    CPPUNIT_ASSERT ( ! finalcut::operator < (h.top().timeout, last) );
+    last = h.top().timeout;
+    h.pop();
+  }
+}
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::eraseTest()
+{
+  finalcut::FObject obj;
+  finalcut::FTimerHeap h;
+
+  for (long t{1}; t <= 6; t++)
+    CPPUNIT_ASSERT ( h.insert (&obj, test::ms(t), test::ms(t * 100)) == t );
+
+  CPPUNIT_ASSERT ( h.erase(3) );
+  CPPUNIT_ASSERT ( h.erase(1) );
+  CPPUNIT_ASSERT ( ! h.erase(1) );  // id double delete
+  CPPUNIT_ASSERT ( h.find(3) == nullptr );
+  CPPUNIT_ASSERT ( h.size() == 4 );
+  CPPUNIT_ASSERT ( h.count(&obj) == 4 );
+  CPPUNIT_ASSERT ( h.top().id == 2 );
+
+  // The smallest free id is reused
+  CPPUNIT_ASSERT ( h.insert (&obj, test::ms(0), test::ms(50)) == 1 );
+  CPPUNIT_ASSERT ( h.insert (&obj, test::ms(0), test::ms(50)) == 3 );
+  CPPUNIT_ASSERT ( h.insert (&obj, test::ms(0), test::ms(50)) == 7 );
+  CPPUNIT_ASSERT ( h.top().id == 1 );
+
+  const int ids[] = { 1, 3, 7, 2, 4, 5, 6 };
+
+  for (int id : ids)
+  {
+    CPPUNIT_ASSERT ( h.top().id == id );
+    h.pop();
+  }
+
+  h.insert (&obj, test::ms(0), test::ms(10));
+  h.clear();
+  CPPUNIT_ASSERT ( h.empty() );
+  CPPUNIT_ASSERT ( h.count(&obj) == 0 );
+  CPPUNIT_ASSERT ( h.insert (&obj, test::ms(0), test::ms(10)) == 1 );
+}
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::objectTest()
+{
+  finalcut::FObject obj1;
+  finalcut::FObject obj2;
+  finalcut::FTimerHeap h;
+
+  for (long t{0}; t < 10; t++)
+    h.insert ( ( t % 2 == 0 ) ? &obj1 : &obj2
+             , test::ms(t), test::ms(1000 - t * 100) );
+
+  CPPUNIT_ASSERT ( h.count(&obj1) == 5 );
+  CPPUNIT_ASSERT ( h.count(&obj2) == 5 );
+  CPPUNIT_ASSERT ( h.top().object == &obj2 );
+
+  CPPUNIT_ASSERT ( h.erase(&obj2) );
+  CPPUNIT_ASSERT ( ! h.erase(&obj2) );
+  CPPUNIT_ASSERT ( h.size() == 5 );
+  CPPUNIT_ASSERT ( h.count(&obj2) == 0 );
+  CPPUNIT_ASSERT ( h.top().object == &obj1 );
+  CPPUNIT_ASSERT ( h.top().id == 9 );
+
+  CPPUNIT_ASSERT ( h.erase(9) );
+  CPPUNIT_ASSERT ( h.count(&obj1) == 4 );
+  CPPUNIT_ASSERT ( h.top().id == 7 );
+  CPPUNIT_ASSERT ( h.erase(&obj1) );
+  CPPUNIT_ASSERT ( h.empty() );
+}
+
+//----------------------------------------------------------------------
+void FTimerHeapTest::rescheduleTest()
+{
+  finalcut::FObject obj;
+  finalcut::FTimerHeap h;
+  h.insert (&obj, test::ms(100), test::ms(100));
+  h.insert (&obj, test::ms(200), test::ms(200));
+  h.insert (&obj, test::ms(300), test::ms(300), true);
+  CPPUNIT_ASSERT ( h.top().id == 1 );
+  CPPUNIT_ASSERT ( ! h.top().one_shot );
+  CPPUNIT_ASSERT ( h.find(3)->one_shot );
+
+  // The next timeout moves the timer to the end of the queue
+  const uInt64 sequence = h.getSequence();
+  h.reschedule (test::ms(400));
+  CPPUNIT_ASSERT ( h.getSequence() == sequence + 1 );
+  CPPUNIT_ASSERT ( h.top().id == 2 );
+  CPPUNIT_ASSERT ( h.find(1)->timeout.tv_sec == 0 );
+  CPPUNIT_ASSERT ( h.find(1)->timeout.tv_usec == 400000 );
+
+  // An equal timeout is placed behind the waiting timers
+  h.reschedule (test::ms(300));
+  CPPUNIT_ASSERT ( h.top().id == 3 );
+  h.pop();
+  CPPUNIT_ASSERT ( h.top().id == 2 );
+  h.pop();
+  CPPUNIT_ASSERT ( h.top().id == 1 );
+  CPPUNIT_ASSERT ( h.size() == 1 );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FTimerHeapTest);
+
+// The general unit test main part
+#include <main-test.inc>
@@ -0,0 +1,343 @@
+/***********************************************************************
+* fwatcher-test.cpp - FWatcher unit tests                              *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+namespace test
+{
+
+//----------------------------------------------------------------------
+// class SocketPair
+//----------------------------------------------------------------------
+
+class SocketPair
+{
+  public:
+    // Constructor
+    SocketPair()
+    {
+      if ( socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0 )
+        sv[0] = sv[1] = -1;
+    }
+
+    // Destructor
+    ~SocketPair()
+    {
+      closeEnd(0);
+      closeEnd(1);
+    }
+
+    // Methods
+    int get (int n)
+    {
+      return sv[n];
+    }
+
+    void closeEnd (int n)
+    {
+      if ( sv[n] != -1 )
+        ::close(sv[n]);
+
+      sv[n] = -1;
+    }
+
+  private:
+    // Data members
+    int sv[2]{-1, -1};
+};
+
+}  // namespace test
+
+
+//----------------------------------------------------------------------
+// class FWatcherTest
+//----------------------------------------------------------------------
+
+class FWatcherTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FWatcherTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void addDelTest();
+    void readTest();
+    void writeTest();
+    void hangupTest();
+    void pollListTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FWatcherTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (addDelTest);
+    CPPUNIT_TEST (readTest);
+    CPPUNIT_TEST (writeTest);
+    CPPUNIT_TEST (hangupTest);
+    CPPUNIT_TEST (pollListTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FWatcherTest::classNameTest()
+{
+  const finalcut::FWatcher w;
+  const finalcut::FString& classname = w.getClassName();
+  CPPUNIT_ASSERT ( classname == "FWatcher" );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::noArgumentTest()
+{
+  finalcut::FWatcher w;
+  CPPUNIT_ASSERT ( w.getWatchCount() == 0 );
+  CPPUNIT_ASSERT ( ! w.isWatched(0) );
+  CPPUNIT_ASSERT ( ! w.hasReadyEvents() );
+  CPPUNIT_ASSERT ( w.poll(0) == 0 );
+  CPPUNIT_ASSERT ( w.dispatch() == 0 );
+  CPPUNIT_ASSERT ( ! w.delWatch(0) );
+
+  finalcut::FWatcher::FPollList list{};
+  w.appendPollList(list);
+  CPPUNIT_ASSERT ( list.empty() );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::addDelTest()
+{
+  finalcut::FWatcher w;
+  auto cb = [] (int, int) { };
+
+  // Invalid file descriptor or callback
+  CPPUNIT_ASSERT ( ! w.addWatch (-1, finalcut::FWatcher::read_event, cb) );
+  CPPUNIT_ASSERT ( ! w.addWatch (3, finalcut::FWatcher::read_event, nullptr) );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 0 );
+
+  CPPUNIT_ASSERT ( w.addWatch (3, finalcut::FWatcher::read_event, cb) );
+  CPPUNIT_ASSERT ( w.addWatch (4, finalcut::FWatcher::write_event, cb) );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 2 );
+  CPPUNIT_ASSERT ( w.isWatched(3) );
+  CPPUNIT_ASSERT ( w.isWatched(4) );
+
+  // A new watch for the same descriptor replaces the old one
+  CPPUNIT_ASSERT ( w.addWatch (3, finalcut::FWatcher::write_event, cb) );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 2 );
+
+  finalcut::FWatcher::FPollList list{};
+  w.appendPollList(list);
+  CPPUNIT_ASSERT ( list.size() == 2 );
+  CPPUNIT_ASSERT ( list[0].fd == 3 );
+  CPPUNIT_ASSERT ( list[0].events == POLLOUT );
+  CPPUNIT_ASSERT ( list[1].fd == 4 );
+  CPPUNIT_ASSERT ( list[1].events == POLLOUT );
+
+  CPPUNIT_ASSERT ( w.delWatch(3) );
+  CPPUNIT_ASSERT ( ! w.delWatch(3) );
+  CPPUNIT_ASSERT ( ! w.isWatched(3) );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 1 );
+  w.delAllWatches();
+  CPPUNIT_ASSERT ( w.getWatchCount() == 0 );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::readTest()
+{
+  test::SocketPair sp;
+  CPPUNIT_ASSERT ( sp.get(0) != -1 );
+  finalcut::FWatcher w;
+  std::string received{};
+  int calls{0};
+  int last_events{0};
+
+  auto cb = [&] (int fd, int events)
+  {
+    char buf[64]{};
+    ssize_t n = ::read (fd, buf, sizeof(buf));
+
+    if ( n > 0 )
+      received.append(buf, std::size_t(n));
+
+    last_events = events;
+    calls++;
+  };
+
+  w.addWatch (sp.get(0), finalcut::FWatcher::read_event, cb);
+
+  // Nothing to read
+  CPPUNIT_ASSERT ( w.poll(0) == 0 );
+  CPPUNIT_ASSERT ( ! w.hasReadyEvents() );
+  CPPUNIT_ASSERT ( w.dispatch() == 0 );
+  CPPUNIT_ASSERT ( calls == 0 );
+
+  CPPUNIT_ASSERT ( ::write (sp.get(1), "metric 42\n", 10) == 10 );
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  CPPUNIT_ASSERT ( w.hasReadyEvents() );
+  CPPUNIT_ASSERT ( calls == 0 );  // Only the dispatch calls the callback
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( ! w.hasReadyEvents() );
+  CPPUNIT_ASSERT ( calls == 1 );
+  CPPUNIT_ASSERT ( last_events == finalcut::FWatcher::read_event );
+  CPPUNIT_ASSERT ( received == "metric 42\n" );
+
+  // All data was read
+  CPPUNIT_ASSERT ( w.poll(0) == 0 );
+
+  // A callback that removes its own watch
+  auto cb_once = [&] (int fd, int)
+  {
+    char buf[64]{};
+    CPPUNIT_ASSERT ( ::read (fd, buf, sizeof(buf)) > 0 );
+    w.delWatch(fd);
+    calls++;
+  };
+
+  w.addWatch (sp.get(0), finalcut::FWatcher::read_event, cb_once);
+  CPPUNIT_ASSERT ( ::write (sp.get(1), "x", 1) == 1 );
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( calls == 2 );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 0 );
+
+  // Ready events of removed watches are dropped
+  w.addWatch (sp.get(0), finalcut::FWatcher::read_event, cb);
+  CPPUNIT_ASSERT ( ::write (sp.get(1), "y", 1) == 1 );
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  w.delWatch (sp.get(0));
+  CPPUNIT_ASSERT ( w.dispatch() == 0 );
+  CPPUNIT_ASSERT ( calls == 2 );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::writeTest()
+{
+  test::SocketPair sp;
+  finalcut::FWatcher w;
+  int calls{0};
+  int last_events{0};
+
+  auto cb = [&] (int, int events)
+  {
+    last_events = events;
+    calls++;
+  };
+
+  // An empty socket buffer can be written
+  w.addWatch ( sp.get(0)
+             , finalcut::FWatcher::read_event | finalcut::FWatcher::write_event
+             , cb );
+  CPPUNIT_ASSERT ( w.poll(0) == 1 );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( calls == 1 );
+  CPPUNIT_ASSERT ( last_events == finalcut::FWatcher::write_event );
+
+  // Readable and writable
+  CPPUNIT_ASSERT ( ::write (sp.get(1), "z", 1) == 1 );
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( last_events == ( finalcut::FWatcher::read_event
+                                  | finalcut::FWatcher::write_event ) );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::hangupTest()
+{
+  test::SocketPair sp;
+  finalcut::FWatcher w;
+  int last_events{0};
+  auto cb = [&] (int, int events) { last_events = events; };
+  w.addWatch (sp.get(0), finalcut::FWatcher::read_event, cb);
+
+  // The peer closes the connection
+  sp.closeEnd(1);
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( last_events & finalcut::FWatcher::read_event );
+  CPPUNIT_ASSERT ( w.isWatched(sp.get(0)) );
+
+  // A closed descriptor is reported once and no longer watched
+  const int fd = sp.get(0);
+  sp.closeEnd(0);
+  last_events = 0;
+  CPPUNIT_ASSERT ( w.poll(1000) == 1 );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( last_events == finalcut::FWatcher::error_event );
+  CPPUNIT_ASSERT ( ! w.isWatched(fd) );
+  CPPUNIT_ASSERT ( w.getWatchCount() == 0 );
+}
+
+//----------------------------------------------------------------------
+void FWatcherTest::pollListTest()
+{
+  // The watched descriptors can be part of another poll() call,
+  // like the one of the keyboard input in the event loop
+
+  test::SocketPair sp1;
+  test::SocketPair sp2;
+  finalcut::FWatcher w;
+  int calls{0};
+  int ready_fd{-1};
+  auto cb = [&] (int fd, int) { ready_fd = fd; calls++; };
+  w.addWatch (sp1.get(0), finalcut::FWatcher::read_event, cb);
+  w.addWatch (sp2.get(0), finalcut::FWatcher::read_event, cb);
+
+  finalcut::FWatcher::FPollList list{};
+  struct pollfd other{};
+  other.fd = -1;  // Ignored by poll()
+  list.push_back(other);
+  w.appendPollList(list);
+  CPPUNIT_ASSERT ( list.size() == 3 );
+
+  CPPUNIT_ASSERT ( ::write (sp2.get(1), "a", 1) == 1 );
+  CPPUNIT_ASSERT ( ::poll (list.data(), list.size(), 1000) == 1 );
+  w.setReadyEvents (&list[1], list.size() - 1);
+  CPPUNIT_ASSERT ( w.hasReadyEvents() );
+  CPPUNIT_ASSERT ( w.dispatch() == 1 );
+  CPPUNIT_ASSERT ( calls == 1 );
+  CPPUNIT_ASSERT ( ready_fd == sp2.get(0) );
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FWatcherTest);
+
+// The general unit test main part
+#include <main-test.inc>
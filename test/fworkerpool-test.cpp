@@ -0,0 +1,211 @@
+/***********************************************************************
+* fworkerpool-test.cpp - FWorkerPool unit tests                        *
+*                                                                      *
+* This file is part of the Final Cut widget toolkit                    *
+*                                                                      *
+* Copyright 2019 Markus Gans                                           *
+*                                                                      *
+* The Final Cut is free software; you can redistribute it and/or       *
+* modify it under the terms of the GNU Lesser General Public License   *
+* as published by the Free Software Foundation; either version 3 of    *
+* the License, or (at your option) any later version.                  *
+*                                                                      *
+* The Final Cut is distributed in the hope that it will be useful,     *
+* but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+* GNU Lesser General Public License for more details.                  *
+*                                                                      *
+* You should have received a copy of the GNU Lesser General Public     *
+* License along with this program.  If not, see                        *
+* <http://www.gnu.org/licenses/>.                                      *
+***********************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <cppunit/BriefTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+#include <final/final.h>
+
+
+//----------------------------------------------------------------------
+// class FWorkerPoolTest
+//----------------------------------------------------------------------
+
+class FWorkerPoolTest : public CPPUNIT_NS::TestFixture
+{
+  public:
+    FWorkerPoolTest()
+    { }
+
+  protected:
+    void classNameTest();
+    void noArgumentTest();
+    void submitTest();
+    void nestedTest();
+    void stealTest();
+    void stopTest();
+
+  private:
+    // Adds code needed to register the test suite
+    CPPUNIT_TEST_SUITE (FWorkerPoolTest);
+
+    // Add a methods to the test suite
+    CPPUNIT_TEST (classNameTest);
+    CPPUNIT_TEST (noArgumentTest);
+    CPPUNIT_TEST (submitTest);
+    CPPUNIT_TEST (nestedTest);
+    CPPUNIT_TEST (stealTest);
+    CPPUNIT_TEST (stopTest);
+
+    // End of test suite definition
+    CPPUNIT_TEST_SUITE_END();
+};
+
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::classNameTest()
+{
+  const finalcut::FWorkerPool pool;
+  const finalcut::FString& classname = pool.getClassName();
+  CPPUNIT_ASSERT ( classname == "FWorkerPool" );
+}
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::noArgumentTest()
+{
+  finalcut::FWorkerPool pool;
+  CPPUNIT_ASSERT ( pool.getWorkerCount() >= 1 );
+  CPPUNIT_ASSERT ( pool.getUnfinishedCount() == 0 );
+  CPPUNIT_ASSERT ( pool.getStolenCount() == 0 );
+  CPPUNIT_ASSERT ( ! pool.isWorkerThread() );
+
+  // The threads are started with the first task
+  CPPUNIT_ASSERT ( ! pool.isRunning() );
+  CPPUNIT_ASSERT ( ! pool.submit(nullptr) );
+  CPPUNIT_ASSERT ( ! pool.isRunning() );
+  pool.waitForIdle();
+}
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::submitTest()
+{
+  finalcut::FWorkerPool pool(3);
+  std::atomic<int> sum{0};
+  std::atomic<int> in_worker{0};
+  CPPUNIT_ASSERT ( pool.getWorkerCount() == 3 );
+
+  for (int i{1}; i <= 1000; i++)
+  {
+    CPPUNIT_ASSERT ( pool.submit ( [&sum, &in_worker, &pool, i] ()
+                                   {
+                                     sum += i;
+
+                                     if ( pool.isWorkerThread() )
+                                       in_worker++;
+                                   } ) );
+  }
+
+  CPPUNIT_ASSERT ( pool.isRunning() );
+  pool.waitForIdle();
+  CPPUNIT_ASSERT ( pool.getUnfinishedCount() == 0 );
+  CPPUNIT_ASSERT ( sum == 500500 );
+  CPPUNIT_ASSERT ( in_worker == 1000 );
+}
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::nestedTest()
+{
+  // Tasks can submit further tasks
+
+  finalcut::FWorkerPool pool(2);
+  std::atomic<int> count{0};
+
+  for (int i{0}; i < 10; i++)
+  {
+    pool.submit ( [&pool, &count] ()
+                  {
+                    for (int j{0}; j < 10; j++)
+                      pool.submit ([&count] () { count++; });
+
+                    pool.waitForIdle();  // Ignored in a worker thread
+                    count++;
+                  } );
+  }
+
+  pool.waitForIdle();
+  CPPUNIT_ASSERT ( count == 110 );
+}
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::stealTest()
+{
+  // A blocked worker loses its queued tasks to the other workers
+
+  finalcut::FWorkerPool pool(2);
+  std::atomic<bool> release{false};
+  std::atomic<int> count{0};
+
+  pool.submit ( [&pool, &release, &count] ()
+                {
+                  // Queued in the deque of this blocked worker
+                  for (int i{0}; i < 20; i++)
+                    pool.submit ([&count] () { count++; });
+
+                  while ( ! release )
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                } );
+
+  for (int i{0}; i < 5000 && count < 20; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  CPPUNIT_ASSERT ( count == 20 );
+  CPPUNIT_ASSERT ( pool.getStolenCount() == 20 );
+  release = true;
+  pool.waitForIdle();
+}
+
+//----------------------------------------------------------------------
+void FWorkerPoolTest::stopTest()
+{
+  finalcut::FWorkerPool pool(1);
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  std::atomic<int> count{0};
+
+  pool.submit ( [&started, &finished] ()
+                {
+                  started = true;
+                  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                  finished = true;
+                } );
+
+  for (int i{0}; i < 10; i++)
+    pool.submit ([&count] () { count++; });
+
+  while ( ! started )
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // Waits for the running task and discards the queued tasks
+  pool.stop();
+  CPPUNIT_ASSERT ( finished );
+  CPPUNIT_ASSERT ( count == 0 );
+  CPPUNIT_ASSERT ( ! pool.isRunning() );
+  CPPUNIT_ASSERT ( pool.getUnfinishedCount() == 0 );
+  CPPUNIT_ASSERT ( ! pool.submit ([&count] () { count++; }) );
+  pool.waitForIdle();
+  pool.stop();
+}
+
+// Put the test suite in the registry
+CPPUNIT_TEST_SUITE_REGISTRATION (FWorkerPoolTest);
+
+// The general unit test main part
+#include <main-test.inc>